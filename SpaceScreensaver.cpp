@@ -0,0 +1,4603 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+#include <omp.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifdef USE_STD_EXECUTION
+#include <execution>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Estructura para representar un planeta
+struct Planet {
+    int centerX, centerY;  // Centro de la órbita
+    float orbitRadius;     // Radio de la órbita
+    float angle;           // Ángulo inicial en la órbita
+    float speed;           // Velocidad angular
+    int size;              // Tamaño del planeta (radio)
+    SDL_Color color;       // Color del planeta
+    bool isVisible;        // Indica si el planeta está visible
+    Uint32 respawnTime;    // Tiempo de regeneración
+    int spriteIndex;       // Sprite pre-rasterizado del gradiente (en planetSprites)
+    double offsetX = 0, offsetY = 0;  // Posición relativa al centro de la órbita (se rota cada paso)
+    double stepCos = 1, stepSin = 0;  // Rotación de un paso: cos y sin de speed
+};
+
+// Posiciones de los planetas (SoA, como la nebulosa). updatePlanets las calcula
+// una vez por paso y el dibujo y las colisiones solo las leen.
+struct PlanetPositions {
+    std::vector<float> x, y;
+    std::vector<float> previousX, previousY;  // Paso anterior (para interpolar)
+};
+
+// Estructura para representar un asteroide
+struct Asteroid {
+    int x, y;
+    int size;
+    int dx, dy;            // Velocidad en x e y
+    SDL_Color color;
+    int previousX = 0, previousY = 0;  // Posición en el paso de simulación anterior
+    float exactX = 0, exactY = 0;        // Posición continua (solo en el modo gravedad)
+    float velocityX = 0, velocityY = 0;  // Velocidad continua (solo en el modo gravedad)
+};
+
+// Estructura para representar una estrella
+struct Star {
+    int x, y;
+    int size;
+    float speed;           // Velocidad de movimiento
+    int previousY = 0;     // Posición en el paso de simulación anterior
+};
+
+struct Explosion {
+    int x, y;              // Posición de la explosión
+    int radiusOrange;       // Radio actual del círculo naranja
+    int radiusYellow;       // Radio actual del círculo amarillo
+    int radiusWhite;        // Radio actual del círculo blanco
+    int maxRadius;          // Radio máximo de la explosión
+    bool isActive;          // Si la explosión está activa o no
+};
+
+// Grupo de explosiones de capacidad fija. Las ranuras libres forman una pila y
+// las activas un arreglo denso en orden de inicio, así que actualizar y dibujar
+// solo recorre las explosiones en curso, sin importar cuántos planetas haya.
+const int defaultExplosionCapacity = 256;
+
+struct ExplosionPool {
+    std::vector<Explosion> slots;
+    std::vector<int> freeSlots;  // Pila de ranuras libres
+    std::vector<int> active;     // Ranuras en uso, en orden de inicio
+    Uint64 dropped;              // Explosiones descartadas por no haber ranuras libres
+};
+
+// Nebulosa en estructura de arreglos (SoA): cada campo de los puntos vive en su
+// propio arreglo contiguo, para que el kernel de actualización procese 8 puntos
+// por instrucción AVX2
+struct Nebula {
+    std::vector<float> x, y;                // Posici�n de cada punto
+    std::vector<float> previousX, previousY;  // Posición en el paso de simulación anterior
+    std::vector<float> dx, dy;              // Velocidad en x e y
+    std::vector<Uint8> size;                // Tama�o del punto
+    std::vector<SDL_Color> color;           // Color actual del punto
+    std::vector<float> colorTransition;     // Controla la transici�n suave entre colores
+    std::vector<int> colorStage;            // Etapa de color actual (0: verde, 1: celeste, etc.)
+};
+
+// Estado completo de la simulación. La fase de actualización (updateWorld) solo
+// modifica el mundo y no toca el renderer; la fase de dibujo (renderWorld) solo
+// lo lee, así que cada una se puede paralelizar y medir por separado.
+struct World {
+    Nebula nebula;
+    std::vector<Star> stars;
+    std::vector<Planet> planets;
+    PlanetPositions planetPositions;
+    std::vector<Asteroid> asteroids;
+    ExplosionPool explosions;
+    Uint32 step = 0;  // Pasos de simulación avanzados (semilla de las reapariciones)
+};
+
+// Interpolar entre el paso de simulación anterior y el actual (alpha en [0, 1])
+inline float interpolate(float previous, float current, float alpha) {
+    return previous + (current - previous) * alpha;
+}
+
+// Generador pseudoaleatorio (SplitMix64) sin estado compartido. En vez de una
+// secuencia global como rand(), cada uso deriva su propio generador de la
+// semilla, un flujo y un índice (punto, paso...), así que los bucles paralelos
+// no compiten por un estado y la escena es la misma con cualquier número de hilos.
+Uint64 randomSeed = 0;  // Se fija con --seed (por defecto, la hora)
+
+enum RandomStream { StreamScene, StreamNebulaInit, StreamNebulaRespawn, StreamStars, StreamJitter, StreamJitterCursor };
+
+inline Uint64 mixBits(Uint64 z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct Random {
+    Uint64 state;
+
+    Uint32 next() { return Uint32(mixBits(state += 0x9E3779B97F4A7C15ull) >> 32); }
+    int below(int n) { return int((Uint64(next()) * Uint32(n)) >> 32); }  // Entero en [0, n)
+};
+
+// Generador para el elemento index de un flujo, derivado de la semilla global
+inline Random streamRandom(RandomStream stream, Uint64 index) {
+    return { mixBits(mixBits(randomSeed + Uint64(stream) * 0x9E3779B97F4A7C15ull) ^ index) };
+}
+
+// Estrategia de ejecución de cada bucle del cuadro, elegida en tiempo de
+// ejecución por etapa (--estrategia, --etapa). Todas producen el mismo mundo y
+// la misma imagen: cada iteración solo escribe en su propio elemento, y el
+// dibujo se graba por bloques que se envían en orden de bloque.
+enum Strategy { StrategySequential, StrategyStatic, StrategyDynamic, StrategyTasks, StrategySimd, StrategyParUnseq, StrategyCount };
+const char* const strategyNames[StrategyCount] = { "secuencial", "static", "dynamic", "tareas", "simd", "par_unseq" };
+
+enum LoopStage {
+    LoopNebulaInit, LoopNebula, LoopStars, LoopPlanets, LoopExplosions, LoopAsteroids, LoopCollisions,
+    LoopDrawNebula, LoopDrawStars, LoopDrawPlanets, LoopDrawExplosions, LoopDrawAsteroids,
+    LoopStageCount
+};
+const char* const loopStageNames[LoopStageCount] = {
+    "iniciar-nebulosa", "nebulosa", "estrellas", "planetas", "explosiones", "asteroides", "colisiones",
+    "dibujar-nebulosa", "dibujar-estrellas", "dibujar-planetas", "dibujar-explosiones", "dibujar-asteroides"
+};
+
+// Combinaciones con nombre. S y P1-P4 reproducen los programas de la primera
+// entrega (SpaceScreensaverS.cpp y ver_paralelas/), donde actualizar y dibujar
+// cada entidad era un mismo bucle; P es el SpaceScreensaverP.cpp original.
+struct StrategyPreset {
+    const char* name;
+    Strategy stages[LoopStageCount];
+};
+const Strategy Seq = StrategySequential, Sta = StrategyStatic, Dyn = StrategyDynamic, Tsk = StrategyTasks,
+               Smd = StrategySimd, Pun = StrategyParUnseq;
+const StrategyPreset strategyPresets[] = {
+    //              inic neb  estr plan expl ast  col  | d-neb d-estr d-plan d-expl d-ast
+    { "S",        { Seq, Seq, Seq, Seq, Seq, Seq, Seq,   Seq,  Seq,   Seq,   Seq,   Seq } },
+    { "P1",       { Sta, Seq, Seq, Seq, Seq, Seq, Seq,   Seq,  Seq,   Seq,   Seq,   Seq } },
+    { "P2",       { Sta, Seq, Sta, Seq, Seq, Seq, Seq,   Seq,  Sta,   Seq,   Seq,   Seq } },
+    { "P3",       { Sta, Seq, Sta, Sta, Sta, Seq, Seq,   Seq,  Sta,   Sta,   Sta,   Seq } },
+    { "P4",       { Sta, Seq, Sta, Sta, Sta, Sta, Seq,   Seq,  Sta,   Sta,   Sta,   Sta } },
+    { "P",        { Sta, Seq, Sta, Seq, Seq, Seq, Sta,   Seq,  Sta,   Seq,   Seq,   Seq } },
+    { "paralelo", { Sta, Sta, Sta, Sta, Sta, Sta, Sta,   Sta,  Sta,   Sta,   Sta,   Sta } },
+    { "dinamico", { Dyn, Dyn, Dyn, Dyn, Dyn, Dyn, Dyn,   Dyn,  Dyn,   Dyn,   Dyn,   Dyn } },
+    { "tareas",   { Tsk, Tsk, Tsk, Tsk, Tsk, Tsk, Tsk,   Tsk,  Tsk,   Tsk,   Tsk,   Tsk } },
+    { "simd",     { Smd, Smd, Smd, Seq, Seq, Seq, Seq,   Seq,  Seq,   Seq,   Seq,   Seq } },
+    { "par_unseq",{ Pun, Pun, Pun, Sta, Sta, Sta, Sta,   Sta,  Sta,   Sta,   Sta,   Sta } },
+};
+const char* const defaultStrategyPreset = "paralelo";
+
+Strategy stageStrategies[LoopStageCount];  // Estrategia vigente de cada etapa
+
+// Aplicar una combinación por nombre; devuelve false si no existe
+bool applyStrategyPreset(const std::string& name) {
+    for (const StrategyPreset& preset : strategyPresets) {
+        if (name == preset.name) {
+            std::copy(preset.stages, preset.stages + LoopStageCount, stageStrategies);
+            return true;
+        }
+    }
+    return false;
+}
+
+// simd y par_unseq solo valen en las etapas cuyo cuerpo puede ejecutarse sin
+// orden entre iteraciones: la inicialización de la nebulosa y las estrellas
+// (código en línea que solo escribe su propio elemento) y la nebulosa, que
+// reparte bloques del kernel AVX2. Planetas, explosiones, asteroides y
+// colisiones ramifican y llaman a funciones fuera de línea, así que omp simd no
+// vectoriza nada y ejecutarlos sin orden no está garantizado; las etapas de
+// dibujo reservan memoria al grabar comandos.
+inline bool allowsUnsequenced(LoopStage stage) {
+    return stage == LoopNebulaInit || stage == LoopNebula || stage == LoopStars;
+}
+
+// Cambiar una sola etapa con "etapa=estrategia"; devuelve false si no es válido
+bool applyStageStrategy(const std::string& assignment) {
+    size_t equals = assignment.find('=');
+    if (equals == std::string::npos) return false;
+    auto stage = std::find(loopStageNames, loopStageNames + LoopStageCount, assignment.substr(0, equals));
+    auto strategy = std::find(strategyNames, strategyNames + StrategyCount, assignment.substr(equals + 1));
+    if (stage == loopStageNames + LoopStageCount || strategy == strategyNames + StrategyCount) return false;
+    Strategy chosen = Strategy(strategy - strategyNames);
+    if (!allowsUnsequenced(LoopStage(stage - loopStageNames)) && (chosen == StrategySimd || chosen == StrategyParUnseq)) return false;
+    stageStrategies[stage - loopStageNames] = chosen;
+    return true;
+}
+
+// Sobrecarga de las regiones paralelas, acumulada desde el inicio. El fork es
+// lo que tarda el último hilo en entrar a la región; el join, lo que tarda el
+// hilo principal en salir después de que el último hilo terminó; cada barrera
+// suma la espera media por hilo (desbalance de carga más el costo de la barrera).
+// Con tareas, la espera incluye las tareas que los hilos ejecutan mientras esperan.
+struct RegionOverhead {
+    std::atomic<Uint64> regions;
+    std::atomic<Uint64> forkJoinTicks;
+    std::atomic<Uint64> barrierTicks;
+};
+RegionOverhead regionOverhead;
+
+// Guardar en target el máximo entre su valor y value
+inline void atomicMax(std::atomic<Uint64>& target, Uint64 value) {
+    Uint64 current = target.load();
+    while (current < value && !target.compare_exchange_weak(current, value)) {}
+}
+
+// Barrera del equipo actual que mide cuánto espera cada hilo
+inline void timedBarrier() {
+    Uint64 arrival = SDL_GetPerformanceCounter();
+    #pragma omp barrier
+    regionOverhead.barrierTicks += (SDL_GetPerformanceCounter() - arrival) / omp_get_num_threads();
+}
+
+// Abrir una región paralela instrumentada: todos los hilos ejecutan body() y
+// terminan en una barrera medida
+template <typename Body>
+void parallelRegion(Body body) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    std::atomic<Uint64> lastEntry(start), lastExit(start);
+    #pragma omp parallel
+    {
+        atomicMax(lastEntry, SDL_GetPerformanceCounter());
+        body();
+        timedBarrier();
+        atomicMax(lastExit, SDL_GetPerformanceCounter());
+    }
+    regionOverhead.regions++;
+    regionOverhead.forkJoinTicks += (lastEntry - start) + (SDL_GetPerformanceCounter() - lastExit);
+}
+
+// Copia de los contadores de regionOverhead, para medir un intervalo
+struct RegionTotals {
+    Uint64 regions, forkJoinTicks, barrierTicks;
+};
+
+RegionTotals regionTotals() {
+    return { regionOverhead.regions, regionOverhead.forkJoinTicks, regionOverhead.barrierTicks };
+}
+
+// Lo acumulado desde start
+RegionTotals regionTotalsSince(const RegionTotals& start) {
+    RegionTotals now = regionTotals();
+    return { now.regions - start.regions, now.forkJoinTicks - start.forkJoinTicks, now.barrierTicks - start.barrierTicks };
+}
+
+// Políticas de ejecución en tiempo de compilación. Cada bucle por elemento es
+// una plantilla sobre la política, así que el compilador genera una versión
+// especializada por política, sin decidir nada dentro del bucle. forEach
+// ejecuta body(i) para i en [0, count) y vuelve cuando terminó; grain es el
+// tamaño de bloque de schedule(dynamic) y de las tareas de taskloop.
+// teamForEach es la misma repartición dentro de una región ya abierta: la
+// llaman todos los hilos del equipo y no espera al resto (nowait), así que
+// otro bucle independiente puede empezar antes de la siguiente barrera.
+// serial ejecuta las partes secuenciales de un bucle por etapas.
+struct SequentialPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t, Body body) {
+        for (size_t i = 0; i < count; i++) body(i);
+    }
+    template <typename Body>
+    static void teamForEach(size_t count, size_t, Body body) {
+        #pragma omp single nowait
+        for (size_t i = 0; i < count; i++) body(i);
+    }
+    template <typename Function>
+    static void serial(Function function) { function(); }
+};
+
+struct StaticPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t grain, Body body) {
+        parallelRegion([&]() { teamForEach(count, grain, body); });
+    }
+    template <typename Body>
+    static void teamForEach(size_t count, size_t, Body body) {
+        #pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < count; i++) body(i);
+    }
+    template <typename Function>
+    static void serial(Function function) { function(); }
+};
+
+struct DynamicPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t grain, Body body) {
+        parallelRegion([&]() { teamForEach(count, grain, body); });
+    }
+    template <typename Body>
+    static void teamForEach(size_t count, size_t grain, Body body) {
+        #pragma omp for schedule(dynamic, grain) nowait
+        for (size_t i = 0; i < count; i++) body(i);
+    }
+    template <typename Function>
+    static void serial(Function function) { function(); }
+};
+
+// Un hilo crea las tareas y las espera (ejecutando también algunas); el resto
+// de los hilos las toma en cuanto llega a una barrera o termina sus bucles. La
+// espera del creador mantiene vivas las variables que usan las tareas.
+struct TaskPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t grain, Body body) {
+        parallelRegion([&]() { teamForEach(count, grain, body); });
+    }
+    template <typename Body>
+    static void teamForEach(size_t count, size_t grain, Body body) {
+        #pragma omp single nowait
+        #pragma omp taskloop grainsize(grain)
+        for (size_t i = 0; i < count; i++) body(i);
+    }
+    template <typename Function>
+    static void serial(Function function) { function(); }
+};
+
+// Un solo hilo, con las iteraciones vectorizables entre sí
+struct SimdPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t, Body body) {
+        #pragma omp simd
+        for (size_t i = 0; i < count; i++) body(i);
+    }
+    template <typename Body>
+    static void teamForEach(size_t count, size_t grain, Body body) {
+        #pragma omp single nowait
+        forEach(count, grain, body);
+    }
+    template <typename Function>
+    static void serial(Function function) { function(); }
+};
+
+#ifdef USE_STD_EXECUTION
+// Índices 0, 1, 2... para recorrer con los algoritmos paralelos de la biblioteca
+const std::vector<size_t>& sequenceIndices(size_t count) {
+    static thread_local std::vector<size_t> indices;
+    while (indices.size() < count) indices.push_back(indices.size());
+    return indices;
+}
+#endif
+
+// Varios hilos y vectorizado. Con -DUSE_STD_EXECUTION usa std::execution::par_unseq
+// (en libstdc++ hace falta enlazar con -ltbb); si no, su equivalente de OpenMP.
+struct ParUnseqPolicy {
+    template <typename Body>
+    static void forEach(size_t count, [[maybe_unused]] size_t grain, Body body) {
+#ifdef USE_STD_EXECUTION
+        const std::vector<size_t>& indices = sequenceIndices(count);
+        std::for_each(std::execution::par_unseq, indices.begin(), indices.begin() + count, body);
+#else
+        parallelRegion([&]() { teamForEach(count, grain, body); });
+#endif
+    }
+    template <typename Body>
+    static void teamForEach(size_t count, [[maybe_unused]] size_t grain, Body body) {
+#ifdef USE_STD_EXECUTION
+        #pragma omp single nowait
+        forEach(count, grain, body);
+#else
+        #pragma omp for simd schedule(static) nowait
+        for (size_t i = 0; i < count; i++) body(i);
+#endif
+    }
+    template <typename Function>
+    static void serial(Function function) { function(); }
+};
+
+// Una política dentro de la región única (--region-unica): cada bucle reparte
+// con la política Inner y termina en una barrera, y las partes secuenciales las
+// ejecuta un solo hilo mientras el resto espera
+template <typename Inner>
+struct TeamPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t grain, Body body) {
+        Inner::teamForEach(count, grain, body);
+        timedBarrier();
+    }
+    template <typename Function>
+    static void serial(Function function) {
+        #pragma omp single nowait
+        function();
+        timedBarrier();
+    }
+};
+
+// Como TeamPolicy, pero sin la barrera: el siguiente bucle independiente puede
+// empezar mientras otros hilos terminan este
+template <typename Inner>
+struct NowaitPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t grain, Body body) {
+        Inner::teamForEach(count, grain, body);
+    }
+};
+
+// Dentro de una tarea del grafo del cuadro (--grafo-tareas): cada bucle se parte
+// con taskloop y la tarea espera a sus hijas, así que termina con el bucle
+// completo; mientras tanto los hilos libres toman tareas de otras etapas
+struct GraphPolicy {
+    template <typename Body>
+    static void forEach(size_t count, size_t grain, Body body) {
+        #pragma omp taskloop grainsize(grain)
+        for (size_t i = 0; i < count; i++) body(i);
+    }
+    template <typename Function>
+    static void serial(Function function) { function(); }
+};
+
+// Llamar a function con la política de la etapa. Se decide una vez por bucle;
+// cada rama llama a una instanciación distinta de la plantilla. simd y par_unseq
+// en una etapa que no los admite (allowsUnsequenced) no se ejecutan: quedan en
+// secuencial y static.
+template <typename Function>
+void withStagePolicy(LoopStage stage, Function function) {
+    Strategy strategy = stageStrategies[stage];
+    if (!allowsUnsequenced(stage) && strategy == StrategySimd) strategy = StrategySequential;
+    if (!allowsUnsequenced(stage) && strategy == StrategyParUnseq) strategy = StrategyStatic;
+    switch (strategy) {
+        case StrategySequential: function(SequentialPolicy()); break;
+        case StrategyStatic:     function(StaticPolicy()); break;
+        case StrategyDynamic:    function(DynamicPolicy()); break;
+        case StrategyTasks:      function(TaskPolicy()); break;
+        case StrategySimd:       function(SimdPolicy()); break;
+        case StrategyParUnseq:   function(ParUnseqPolicy()); break;
+        case StrategyCount:      break;
+    }
+}
+
+// Ejecutar body(i) para i en [0, count) con la política de la etapa
+template <typename Body>
+void runLoop(LoopStage stage, size_t count, size_t grain, Body body) {
+    withStagePolicy(stage, [&](auto policy) { decltype(policy)::forEach(count, grain, body); });
+}
+
+struct Sprite;
+
+// Comandos de dibujo grabados por un hilo. Los hilos de un bucle paralelo nunca
+// llaman a SDL ni escriben el framebuffer: graban lotes (rectángulos o puntos de
+// un mismo color, o copias de sprites) y el hilo principal los envía después.
+struct DrawCommandList {
+    enum Kind { Rects, Points, SpriteCopy };
+    struct Command {
+        Kind kind;
+        SDL_Color color;
+        int first, count;         // Rango en rects o points
+        const Sprite* sprite;     // Solo para SpriteCopy
+        int x, y;
+    };
+    std::vector<Command> commands;
+    std::vector<SDL_Rect> rects;
+    std::vector<SDL_Point> points;
+
+    void clear() {
+        commands.clear();
+        rects.clear();
+        points.clear();
+    }
+};
+
+// Destino de dibujo: el renderer de SDL, un framebuffer ARGB8888 en CPU o una
+// lista de comandos. Con el backend de CPU toda la escena se rasteriza en
+// memoria y se sube a la pantalla con una sola textura por cuadro.
+struct Canvas {
+    SDL_Renderer* renderer;     // Si no es nullptr, se dibuja con llamadas a SDL
+    Uint32* pixels;             // Framebuffer ARGB8888 (backend de CPU)
+    int width, height;
+    DrawCommandList* commands = nullptr;  // Si no es nullptr, solo se graban los comandos
+};
+
+// Empaquetar un color en formato ARGB8888
+inline Uint32 packColor(SDL_Color color) {
+    return (Uint32(color.a) << 24) | (Uint32(color.r) << 16) | (Uint32(color.g) << 8) | Uint32(color.b);
+}
+
+// Rellenar todo el lienzo con un color
+void clearCanvas(Canvas& canvas, SDL_Color color) {
+    if (canvas.renderer) {
+        SDL_SetRenderDrawColor(canvas.renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderClear(canvas.renderer);
+        return;
+    }
+    std::fill(canvas.pixels, canvas.pixels + canvas.width * canvas.height, packColor(color));
+}
+
+// Agregar un lote a la lista, uniéndolo al anterior si es del mismo tipo y color
+void recordCommand(DrawCommandList& list, DrawCommandList::Kind kind, int first, int count, SDL_Color color) {
+    if (!list.commands.empty()) {
+        DrawCommandList::Command& last = list.commands.back();
+        if (last.kind == kind && packColor(last.color) == packColor(color) && last.first + last.count == first) {
+            last.count += count;
+            return;
+        }
+    }
+    list.commands.push_back({ kind, color, first, count, nullptr, 0, 0 });
+}
+
+// Rellenar un lote de rectángulos del mismo color (recortados al lienzo)
+void fillRects(Canvas& canvas, const SDL_Rect* rects, int count, SDL_Color color) {
+    if (canvas.commands) {
+        DrawCommandList& list = *canvas.commands;
+        recordCommand(list, DrawCommandList::Rects, int(list.rects.size()), count, color);
+        list.rects.insert(list.rects.end(), rects, rects + count);
+        return;
+    }
+    if (canvas.renderer) {
+        SDL_SetRenderDrawColor(canvas.renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRects(canvas.renderer, rects, count);
+        return;
+    }
+    Uint32 packed = packColor(color);
+    for (int i = 0; i < count; i++) {
+        int x0 = std::max(rects[i].x, 0);
+        int y0 = std::max(rects[i].y, 0);
+        int x1 = std::min(rects[i].x + rects[i].w, canvas.width);
+        int y1 = std::min(rects[i].y + rects[i].h, canvas.height);
+        if (x0 >= x1) continue;  // Completamente fuera del lienzo en x
+        for (int y = y0; y < y1; y++) {
+            std::fill(canvas.pixels + y * canvas.width + x0, canvas.pixels + y * canvas.width + x1, packed);
+        }
+    }
+}
+
+// Dibujar un lote de puntos del mismo color (los que caen fuera se descartan)
+void drawPoints(Canvas& canvas, const SDL_Point* points, int count, SDL_Color color) {
+    if (canvas.commands) {
+        DrawCommandList& list = *canvas.commands;
+        recordCommand(list, DrawCommandList::Points, int(list.points.size()), count, color);
+        list.points.insert(list.points.end(), points, points + count);
+        return;
+    }
+    if (canvas.renderer) {
+        SDL_SetRenderDrawColor(canvas.renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderDrawPoints(canvas.renderer, points, count);
+        return;
+    }
+    Uint32 packed = packColor(color);
+    for (int i = 0; i < count; i++) {
+        if (points[i].x >= 0 && points[i].x < canvas.width && points[i].y >= 0 && points[i].y < canvas.height) {
+            canvas.pixels[points[i].y * canvas.width + points[i].x] = packed;
+        }
+    }
+}
+
+// Calcula los tramos horizontales (uno por fila) que cubren un círculo.
+// Cubre exactamente los mismos píxeles que el recorrido original de la caja
+// (2r)x(2r): dx y dy van de -radius + 1 a radius. Devuelve la cantidad de tramos.
+int buildCircleSpans(int x, int y, int radius, SDL_Rect* spans) {
+    int count = 0;
+    for (int dy = -radius + 1; dy <= radius; dy++) {
+        // Mitad del ancho de la fila: mayor m con m * m <= radius^2 - dy^2
+        int remaining = radius * radius - dy * dy;
+        int halfWidth = int(std::sqrt(float(remaining)));
+        while (halfWidth * halfWidth > remaining) halfWidth--;
+        while ((halfWidth + 1) * (halfWidth + 1) <= remaining) halfWidth++;
+
+        int left = std::max(-halfWidth, -radius + 1);
+        spans[count++] = { x + left, y + dy, halfWidth - left + 1, 1 };
+    }
+    return count;
+}
+
+// Función para dibujar un círculo (un tramo por fila, enviados en un solo lote)
+void drawCircle(Canvas& canvas, int x, int y, int radius, SDL_Color color) {
+    if (radius <= 0) return;
+
+    static thread_local std::vector<SDL_Rect> spans;
+    if (spans.size() < size_t(radius * 2)) spans.resize(radius * 2);
+    int count = buildCircleSpans(x, y, radius, spans.data());
+
+    fillRects(canvas, spans.data(), count, color);
+}
+
+// Versión original de drawCircle: un SDL_RenderDrawPoint por píxel.
+// Se conserva solo como referencia para el benchmark de círculos.
+void drawCirclePerPixel(SDL_Renderer* renderer, int x, int y, int radius, SDL_Color color) {
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    for (int w = 0; w < radius * 2; w++) {
+        for (int h = 0; h < radius * 2; h++) {
+            int dx = radius - w; // desplazamiento horizontal
+            int dy = radius - h; // desplazamiento vertical
+            if ((dx * dx + dy * dy) <= (radius * radius)) {
+                SDL_RenderDrawPoint(renderer, x + dx, y + dy);
+            }
+        }
+    }
+}
+
+// Dibujar el gradiente de un planeta como círculos concéntricos cada vez más oscuros
+void drawPlanetGradient(Canvas& canvas, int x, int y, int size, SDL_Color color) {
+    // Crear un gradiente para hacer los planetas más realistas
+    for (int i = 0; i < size; i++) {
+        SDL_Color gradientColor = { Uint8(color.r * (size - i) / size),
+                                    Uint8(color.g * (size - i) / size),
+                                    Uint8(color.b * (size - i) / size), 255 };
+        drawCircle(canvas, x, y, size - i, gradientColor);
+    }
+}
+
+// Imagen pre-rasterizada (ARGB8888, alfa 0 = transparente) para las partes de
+// la escena que no cambian entre cuadros; en cada cuadro solo se copia
+struct Sprite {
+    int width, height;
+    int originX, originY;        // Posición del centro dentro de la imagen
+    std::vector<Uint32> pixels;
+    SDL_Texture* texture;        // Copia en textura para el backend de SDL
+};
+
+// Crear un sprite vacío (transparente) con el centro en (originX, originY)
+Sprite createSprite(int width, int height, int originX, int originY) {
+    return { width, height, originX, originY, std::vector<Uint32>(width * height, 0), nullptr };
+}
+
+// Lienzo para rasterizar sobre los píxeles del sprite
+Canvas spriteCanvas(Sprite& sprite) {
+    return { nullptr, sprite.pixels.data(), sprite.width, sprite.height };
+}
+
+// Subir el sprite a una textura si se dibuja con el renderer de SDL
+void uploadSprite(Canvas& canvas, Sprite& sprite) {
+    if (canvas.renderer == nullptr) return;
+    sprite.texture = SDL_CreateTexture(canvas.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, sprite.width, sprite.height);
+    SDL_UpdateTexture(sprite.texture, nullptr, sprite.pixels.data(), sprite.width * sizeof(Uint32));
+    SDL_SetTextureBlendMode(sprite.texture, SDL_BLENDMODE_BLEND);
+}
+
+// Liberar la textura de un sprite
+void releaseSprite(Sprite& sprite) {
+    if (sprite.texture) SDL_DestroyTexture(sprite.texture);
+    sprite.texture = nullptr;
+}
+
+// Copiar un sprite con su centro en (x, y)
+void drawSprite(Canvas& canvas, const Sprite& sprite, int x, int y) {
+    if (canvas.commands) {
+        canvas.commands->commands.push_back({ DrawCommandList::SpriteCopy, {0, 0, 0, 0}, 0, 0, &sprite, x, y });
+        return;
+    }
+    int left = x - sprite.originX;
+    int top = y - sprite.originY;
+    if (canvas.renderer) {
+        SDL_Rect destination = { left, top, sprite.width, sprite.height };
+        SDL_RenderCopy(canvas.renderer, sprite.texture, nullptr, &destination);
+        return;
+    }
+    int x0 = std::max(left, 0), x1 = std::min(left + sprite.width, canvas.width);
+    int y0 = std::max(top, 0), y1 = std::min(top + sprite.height, canvas.height);
+    for (int row = y0; row < y1; row++) {
+        const Uint32* source = sprite.pixels.data() + (row - top) * sprite.width - left;
+        Uint32* destination = canvas.pixels + row * canvas.width;
+        for (int column = x0; column < x1; column++) {
+            if (source[column] >> 24) destination[column] = source[column];
+        }
+    }
+}
+
+// Enviar al lienzo los comandos grabados, en el orden en que se grabaron
+void submitDrawCommands(Canvas& canvas, const DrawCommandList& list) {
+    for (const DrawCommandList::Command& command : list.commands) {
+        switch (command.kind) {
+            case DrawCommandList::Rects:
+                fillRects(canvas, list.rects.data() + command.first, command.count, command.color);
+                break;
+            case DrawCommandList::Points:
+                drawPoints(canvas, list.points.data() + command.first, command.count, command.color);
+                break;
+            case DrawCommandList::SpriteCopy:
+                drawSprite(canvas, *command.sprite, command.x, command.y);
+                break;
+        }
+    }
+}
+
+std::vector<DrawCommandList> drawCommandLists;  // Una lista por bloque, reutilizada entre cuadros
+
+// Bloques en que se parte un dibujo de count elementos: uno en secuencial, uno
+// por hilo con static y cuatro por hilo con dynamic y tareas, para repartir la carga
+size_t drawBlockCount(LoopStage stage, size_t count, size_t threads) {
+    if (stageStrategies[stage] == StrategySequential) return 1;
+    return std::max<size_t>(1, std::min(count, stageStrategies[stage] == StrategyStatic ? threads : threads * 4));
+}
+
+// Grabar en list los elementos del bloque block de blocks
+template <typename Body>
+void recordDrawBlock(DrawCommandList& list, const Canvas& canvas, size_t count, size_t block, size_t blocks, Body& body) {
+    list.clear();
+    Canvas recorder = { nullptr, nullptr, canvas.width, canvas.height, &list };
+    for (size_t i = count * block / blocks; i < count * (block + 1) / blocks; i++) {
+        body(recorder, i);
+    }
+}
+
+// Dibujo dentro de la región única o del grafo de tareas: cada etapa graba en
+// sus propias listas, sin esperar a las demás, y el hilo principal las envía
+// todas al final
+bool recordingInTeam = false;
+bool recordingInGraph = false;
+std::vector<DrawCommandList> teamDrawLists[LoopStageCount];
+size_t teamDrawBlocks[LoopStageCount];  // Bloques grabados en el último cuadro
+
+// Dejar listas para threads hilos en cada etapa (antes de abrir la región)
+void prepareTeamDrawLists(size_t threads) {
+    for (std::vector<DrawCommandList>& lists : teamDrawLists) {
+        if (lists.size() < threads * 4) lists.resize(threads * 4);
+    }
+}
+
+// Enviar al lienzo lo que grabó una etapa en la región única
+void submitTeamDraw(Canvas& canvas, LoopStage stage) {
+    for (size_t block = 0; block < teamDrawBlocks[stage]; block++) {
+        submitDrawCommands(canvas, teamDrawLists[stage][block]);
+    }
+}
+
+// Ejecutar body(lienzo, i) para i en [0, count) con la estrategia de la etapa.
+// En secuencial se dibuja directo; si no, los índices se parten en bloques
+// contiguos, cada bloque graba en su propia lista de comandos y al terminar el
+// hilo principal las envía en orden de bloque. La imagen resultante es la misma
+// que la del bucle secuencial, sin importar qué hilo tomó cada bloque. En la
+// región única y en el grafo de tareas solo se graba y el envío queda para
+// submitTeamDraw.
+template <typename Body>
+void parallelDraw(Canvas& canvas, LoopStage stage, size_t count, Body body) {
+    if (recordingInTeam || recordingInGraph) {
+        std::vector<DrawCommandList>& lists = teamDrawLists[stage];
+        size_t blocks = drawBlockCount(stage, count, omp_get_num_threads());
+        auto record = [&](size_t block) { recordDrawBlock(lists[block], canvas, count, block, blocks, body); };
+        if (recordingInGraph) {
+            teamDrawBlocks[stage] = blocks;  // Una sola tarea por etapa
+            GraphPolicy::forEach(blocks, 1, record);
+            return;
+        }
+        if (omp_get_thread_num() == 0) teamDrawBlocks[stage] = blocks;
+        withStagePolicy(stage, [&](auto policy) { decltype(policy)::teamForEach(blocks, 1, record); });
+        return;
+    }
+    if (stageStrategies[stage] == StrategySequential) {
+        for (size_t i = 0; i < count; i++) body(canvas, i);
+        return;
+    }
+    size_t blocks = drawBlockCount(stage, count, omp_get_max_threads());
+    if (drawCommandLists.size() < blocks) drawCommandLists.resize(blocks);
+    runLoop(stage, blocks, 1, [&](size_t block) {
+        recordDrawBlock(drawCommandLists[block], canvas, count, block, blocks, body);
+    });
+    for (size_t block = 0; block < blocks; block++) {
+        submitDrawCommands(canvas, drawCommandLists[block]);
+    }
+}
+
+// Gradientes de planetas rasterizados una sola vez, por tamaño y color. Los
+// círculos de drawCircle ocupan los desplazamientos -size + 1 .. size, así que
+// el sprite mide 2 * size con el centro en (size - 1, size - 1).
+std::vector<Sprite> planetSprites;
+std::unordered_map<Uint32, int> planetSpriteLookup;  // (tamaño, color) -> índice
+
+// Obtener (o crear) el sprite de un planeta con el tamaño y color dados
+int getPlanetSprite(Canvas& canvas, int size, SDL_Color color) {
+    Uint32 key = (Uint32(size) << 24) | (Uint32(color.r) << 16) | (Uint32(color.g) << 8) | Uint32(color.b);
+    auto found = planetSpriteLookup.find(key);
+    if (found != planetSpriteLookup.end()) return found->second;
+
+    Sprite sprite = createSprite(size * 2, size * 2, size - 1, size - 1);
+    Canvas target = spriteCanvas(sprite);
+    drawPlanetGradient(target, size - 1, size - 1, size, color);
+    uploadSprite(canvas, sprite);
+
+    planetSprites.push_back(std::move(sprite));
+    planetSpriteLookup[key] = int(planetSprites.size()) - 1;
+    return int(planetSprites.size()) - 1;
+}
+
+// Liberar los sprites de planetas y sus texturas
+void releasePlanetSprites() {
+    for (Sprite& sprite : planetSprites) releaseSprite(sprite);
+    planetSprites.clear();
+    planetSpriteLookup.clear();
+}
+
+// Preparar la rotación incremental de la órbita. Es el único cálculo
+// trigonométrico del planeta: después cada paso solo multiplica y suma.
+void initPlanetOrbit(Planet& planet) {
+    planet.offsetX = planet.orbitRadius * cos(planet.angle);
+    planet.offsetY = planet.orbitRadius * sin(planet.angle);
+    planet.stepCos = cos(planet.speed);
+    planet.stepSin = sin(planet.speed);
+}
+
+// Guardar en positions la posición actual del planeta i
+inline void storePlanetPosition(PlanetPositions& positions, size_t i, const Planet& planet) {
+    positions.x[i] = float(planet.centerX + planet.offsetX);
+    positions.y[i] = float(planet.centerY + planet.offsetY);
+}
+
+// Preparar las órbitas de todos los planetas y sus posiciones iniciales
+void initPlanetOrbits(std::vector<Planet>& planets, PlanetPositions& positions) {
+    positions.x.resize(planets.size());
+    positions.y.resize(planets.size());
+    for (size_t i = 0; i < planets.size(); i++) {
+        initPlanetOrbit(planets[i]);
+        storePlanetPosition(positions, i, planets[i]);
+    }
+    positions.previousX = positions.x;
+    positions.previousY = positions.y;
+}
+
+// Función para actualizar un planeta (avanzar en la órbita o reaparecer)
+void updatePlanet(Planet& planet, Uint32 currentTime) {
+    if (planet.isVisible) {
+        // Avanzar la órbita rotando el desplazamiento, sin trigonometría por paso
+        double offsetX = planet.offsetX;
+        planet.offsetX = offsetX * planet.stepCos - planet.offsetY * planet.stepSin;
+        planet.offsetY = offsetX * planet.stepSin + planet.offsetY * planet.stepCos;
+    } else if (currentTime >= planet.respawnTime) {
+        planet.isVisible = true;
+    }
+}
+
+// Función para dibujar un planeta, interpolado entre los dos últimos pasos
+void drawPlanet(Canvas& canvas, const Planet& planet, int x, int y) {
+    if (!planet.isVisible) return;
+    drawSprite(canvas, planetSprites[planet.spriteIndex], x, y);
+}
+
+// Función para actualizar un asteroide
+void updateAsteroid(Asteroid& asteroid) {
+    asteroid.x += asteroid.dx;
+    asteroid.y += asteroid.dy;
+
+    // Rebote en los bordes
+    if (asteroid.x <= 0 || asteroid.x >= 640) asteroid.dx = -asteroid.dx;
+    if (asteroid.y <= 0 || asteroid.y >= 480) asteroid.dy = -asteroid.dy;
+}
+
+// Función para dibujar un asteroide, interpolado entre los dos últimos pasos
+void drawAsteroid(Canvas& canvas, const Asteroid& asteroid, float alpha) {
+    int x = interpolate(asteroid.previousX, asteroid.x, alpha);
+    int y = interpolate(asteroid.previousY, asteroid.y, alpha);
+    SDL_Rect rect = { x - asteroid.size / 2, y - asteroid.size / 2, asteroid.size, asteroid.size };
+    fillRects(canvas, &rect, 1, { asteroid.color.r, asteroid.color.g, asteroid.color.b, 255 });
+}
+
+void initNebula(Nebula& nebula, int numPoints) {
+    nebula.x.resize(numPoints);
+    nebula.y.resize(numPoints);
+    nebula.dx.assign(numPoints, 0.0f);  // Velocidad inicial (muy lenta, se acelerar� gradualmente)
+    nebula.dy.assign(numPoints, 0.0f);
+    nebula.size.resize(numPoints);
+    nebula.color.resize(numPoints);
+    nebula.colorTransition.assign(numPoints, 0.0f);
+    nebula.colorStage.assign(numPoints, 0);
+    nebula.previousX.resize(numPoints);
+    nebula.previousY.resize(numPoints);
+
+    runLoop(LoopNebulaInit, numPoints, 4096, [&](size_t i) {
+        Random random = streamRandom(StreamNebulaInit, i);
+
+        // Generar posici�n aleatoria en los bordes exteriores de la pantalla
+        nebula.x[i] = random.below(640);
+        nebula.y[i] = random.below(480);
+        
+        // Tama�o peque�o
+        nebula.size[i] = 1 + random.below(2);
+
+        // Generar colores en la gama de azul, morado, rosado
+        int red = 150 + random.below(106);
+        int green = 50 + random.below(100);
+        int blue = 150 + random.below(106);
+        nebula.color[i] = { Uint8(red), Uint8(green), Uint8(blue), 128 }; // Semi-transparente
+        nebula.previousX[i] = nebula.x[i];
+        nebula.previousY[i] = nebula.y[i];
+    });
+}
+
+// Colores clave para la interpolaci�n
+const int numNebulaColors = 6;
+const SDL_Color nebulaColors[numNebulaColors] = {
+    {128, 0, 128, 255},  // Morado
+    {194, 52, 158, 255},  // M Morado
+    {255, 105, 180, 255}, // Rosado
+    {0, 255, 255, 255},  // Celeste
+    {0, 128, 255, 255},  // M Celeste
+    {64, 0, 194, 255}    // M azul
+};
+
+// Regenerar un punto que lleg� cerca del centro
+void respawnNebulaPoint(Nebula& nebula, size_t i, Uint32 step) {
+    Random random = streamRandom(StreamNebulaRespawn, (Uint64(step) << 32) | i);
+
+    // Reaparecer en una nueva posici�n aleatoria en los bordes exteriores
+    nebula.x[i] = random.below(640);
+    nebula.y[i] = random.below(480);
+    nebula.dx[i] = 0;
+    nebula.dy[i] = 0;
+    nebula.previousX[i] = nebula.x[i];  // Sin interpolar el salto
+    nebula.previousY[i] = nebula.y[i];
+    nebula.colorStage[i] = random.below(numNebulaColors); // Comienza en una etapa de color aleatoria
+}
+
+// Actualizar los puntos [begin, end) de la nebulosa, uno a la vez
+void updateNebulaScalar(Nebula& nebula, size_t begin, size_t end, Uint32 step) {
+    const float centerX = 320.0f;
+    const float centerY = 240.0f;
+
+    // Funci�n de interpolaci�n de color
+    auto interpolateColor = [](SDL_Color colorA, SDL_Color colorB, float t) -> SDL_Color {
+        SDL_Color result;
+        result.r = Uint8(colorA.r + t * (colorB.r - colorA.r));
+        result.g = Uint8(colorA.g + t * (colorB.g - colorA.g));
+        result.b = Uint8(colorA.b + t * (colorB.b - colorA.b));
+        result.a = 255;  // Mantener la opacidad fija
+        return result;
+    };
+
+    for (size_t i = begin; i < end; i++) {
+        // Calcular la direcci�n hacia el centro
+        float directionX = centerX - nebula.x[i];
+        float directionY = centerY - nebula.y[i];
+
+        // Calcular la distancia al centro
+        float distance = std::sqrt(directionX * directionX + directionY * directionY);
+
+        // Acelerar el punto mientras se acerca al centro
+        if (distance > 0) {
+            nebula.dx[i] += (directionX / distance) * 0.05f;  // Aumentar velocidad hacia el centro
+            nebula.dy[i] += (directionY / distance) * 0.05f;
+        }
+
+        // Actualizar la posici�n del punto
+        nebula.x[i] += nebula.dx[i];
+        nebula.y[i] += nebula.dy[i];
+
+        // Si el punto ha llegado cerca del centro, regenerarlo
+        if (distance < 5) {
+            respawnNebulaPoint(nebula, i, step);
+        }
+
+        // Interpolar el color suavemente
+        SDL_Color startColor = nebulaColors[nebula.colorStage[i]];
+        SDL_Color endColor = nebulaColors[(nebula.colorStage[i] + 1) % numNebulaColors];
+        nebula.color[i] = interpolateColor(startColor, endColor, nebula.colorTransition[i]);
+
+        // Incrementar la transici�n de color
+        nebula.colorTransition[i] += 0.02f;  // Ajustar velocidad de cambio de color
+        if (nebula.colorTransition[i] >= 1.0f) {
+            nebula.colorTransition[i] = 0.0f;
+            nebula.colorStage[i] = (nebula.colorStage[i] + 1) % numNebulaColors;  // Cambiar al siguiente color
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Versión AVX2 de updateNebulaScalar: procesa 8 puntos por iteración. La
+// atracción, la integración y los colores se calculan con instrucciones
+// vectoriales; solo los puntos que deben regenerarse (máscara de distancia < 5)
+// pasan por respawnNebulaPoint, en el mismo orden que la versión escalar.
+__attribute__((target("avx2")))
+void updateNebulaAVX2(Nebula& nebula, size_t begin, size_t end, Uint32 step) {
+    float tableRed[numNebulaColors], tableGreen[numNebulaColors], tableBlue[numNebulaColors];
+    for (int c = 0; c < numNebulaColors; c++) {
+        tableRed[c] = nebulaColors[c].r;
+        tableGreen[c] = nebulaColors[c].g;
+        tableBlue[c] = nebulaColors[c].b;
+    }
+    const float* channelTables[3] = { tableRed, tableGreen, tableBlue };
+
+    const __m256 centerX = _mm256_set1_ps(320.0f);
+    const __m256 centerY = _mm256_set1_ps(240.0f);
+    const __m256 acceleration = _mm256_set1_ps(0.05f);
+    const __m256 respawnDistance = _mm256_set1_ps(5.0f);
+    const __m256 transitionStep = _mm256_set1_ps(0.02f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i stageCount = _mm256_set1_epi32(numNebulaColors);
+    const __m256i opaque = _mm256_set1_epi32(int(0xFF000000u));
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        // Atracción hacia el centro e integración
+        __m256 x = _mm256_loadu_ps(&nebula.x[i]);
+        __m256 y = _mm256_loadu_ps(&nebula.y[i]);
+        __m256 dx = _mm256_loadu_ps(&nebula.dx[i]);
+        __m256 dy = _mm256_loadu_ps(&nebula.dy[i]);
+        __m256 directionX = _mm256_sub_ps(centerX, x);
+        __m256 directionY = _mm256_sub_ps(centerY, y);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(directionX, directionX),
+                                                       _mm256_mul_ps(directionY, directionY)));
+        __m256 moving = _mm256_cmp_ps(distance, zero, _CMP_GT_OQ);
+        dx = _mm256_add_ps(dx, _mm256_and_ps(moving, _mm256_mul_ps(_mm256_div_ps(directionX, distance), acceleration)));
+        dy = _mm256_add_ps(dy, _mm256_and_ps(moving, _mm256_mul_ps(_mm256_div_ps(directionY, distance), acceleration)));
+        _mm256_storeu_ps(&nebula.x[i], _mm256_add_ps(x, dx));
+        _mm256_storeu_ps(&nebula.y[i], _mm256_add_ps(y, dy));
+        _mm256_storeu_ps(&nebula.dx[i], dx);
+        _mm256_storeu_ps(&nebula.dy[i], dy);
+
+        // Regenerar los puntos que llegaron cerca del centro
+        int respawnMask = _mm256_movemask_ps(_mm256_cmp_ps(distance, respawnDistance, _CMP_LT_OQ));
+        while (respawnMask) {
+            respawnNebulaPoint(nebula, i + __builtin_ctz(respawnMask), step);
+            respawnMask &= respawnMask - 1;
+        }
+
+        // Interpolar el color entre la etapa actual y la siguiente
+        __m256i stage = _mm256_loadu_si256((const __m256i*)&nebula.colorStage[i]);
+        __m256i next = _mm256_add_epi32(stage, _mm256_set1_epi32(1));
+        next = _mm256_andnot_si256(_mm256_cmpeq_epi32(next, stageCount), next);
+        __m256 t = _mm256_loadu_ps(&nebula.colorTransition[i]);
+        __m256i packed = opaque;
+        for (int c = 0; c < 3; c++) {
+            __m256 from = _mm256_i32gather_ps(channelTables[c], stage, 4);
+            __m256 to = _mm256_i32gather_ps(channelTables[c], next, 4);
+            __m256i value = _mm256_cvttps_epi32(_mm256_add_ps(from, _mm256_mul_ps(t, _mm256_sub_ps(to, from))));
+            packed = _mm256_or_si256(packed, _mm256_slli_epi32(value, 8 * c));  // SDL_Color en memoria: r, g, b, a
+        }
+        _mm256_storeu_si256((__m256i*)&nebula.color[i], packed);
+
+        // Avanzar la transición y pasar a la siguiente etapa al llegar a 1
+        t = _mm256_add_ps(t, transitionStep);
+        __m256 wrapped = _mm256_cmp_ps(t, one, _CMP_GE_OQ);
+        _mm256_storeu_ps(&nebula.colorTransition[i], _mm256_andnot_ps(wrapped, t));
+        stage = _mm256_blendv_epi8(stage, next, _mm256_castps_si256(wrapped));
+        _mm256_storeu_si256((__m256i*)&nebula.colorStage[i], stage);
+    }
+
+    // Puntos restantes (menos de 8)
+    updateNebulaScalar(nebula, i, end, step);
+}
+#endif
+
+// Indica si la CPU soporta AVX2; el kernel se elige en tiempo de ejecución
+bool cpuHasAVX2() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// Actualizar los puntos [begin, end) con el mejor kernel disponible
+void updateNebula(Nebula& nebula, size_t begin, size_t end, Uint32 step) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (cpuHasAVX2()) {
+        updateNebulaAVX2(nebula, begin, end, step);
+        return;
+    }
+#endif
+    updateNebulaScalar(nebula, begin, end, step);
+}
+
+const size_t nebulaBlockSize = 1024;  // Múltiplo de 8
+
+// Actualizar toda la nebulosa en bloques de nebulaBlockSize puntos, para que
+// el kernel AVX2 procese grupos completos de 8 con cualquier estrategia.
+template <typename Policy>
+void updateAllNebula(Policy, Nebula& nebula, Uint32 step) {
+    size_t count = nebula.x.size();
+    Policy::forEach((count + nebulaBlockSize - 1) / nebulaBlockSize, 4, [&](size_t block) {
+        updateNebula(nebula, block * nebulaBlockSize, std::min(count, (block + 1) * nebulaBlockSize), step);
+    });
+}
+
+void updateAllNebula(Nebula& nebula, Uint32 step) {
+    withStagePolicy(LoopNebula, [&](auto policy) { updateAllNebula(policy, nebula, step); });
+}
+
+// Dibujar los puntos de la nebulosa, interpolados entre los dos últimos pasos
+void drawNebula(Canvas& canvas, const Nebula& nebula, float alpha) {
+    parallelDraw(canvas, LoopDrawNebula, nebula.x.size(), [&](Canvas& target, size_t i) {
+        SDL_Rect rect = { int(interpolate(nebula.previousX[i], nebula.x[i], alpha)),
+                          int(interpolate(nebula.previousY[i], nebula.y[i], alpha)), nebula.size[i], nebula.size[i] };
+        fillRects(target, &rect, 1, nebula.color[i]);
+    });
+}
+
+// Tabla de valores aleatorios para la distorsión de los aros y del disco de
+// acreción. initBlackHole la genera a partir de la semilla y cada figura la
+// recorre desde un punto distinto en cada paso, así que la distorsión se sigue
+// animando sin llamar a rand() por píxel.
+const int jitterTableSize = 4096;  // Potencia de 2
+std::vector<Uint8> jitterTable;
+
+void initJitterTable() {
+    jitterTable.resize(jitterTableSize);
+    Random random = streamRandom(StreamJitter, 0);
+    for (Uint8& value : jitterTable) value = Uint8(random.below(256));
+}
+
+// Punto de partida en la tabla para una figura en un paso de simulación. Depende
+// solo de la semilla, el paso y la figura (los aros usan su radio y las líneas
+// 0x10000 más su largo), no del hilo que dibuja ni de lo que dibujó antes.
+inline Uint32 jitterCursor(Uint32 step, Uint32 shape) {
+    return streamRandom(StreamJitterCursor, (Uint64(step) << 32) | shape).next();
+}
+
+// Dibujar puntos (desplazamientos respecto a un centro) con una pequeña distorsión
+// aleatoria en cada punto, tomada de la tabla desde cursor
+void drawJitteredPoints(Canvas& canvas, int x, int y, const std::vector<SDL_Point>& offsets, SDL_Color color, int distortionAmount, Uint32 cursor) {
+    static thread_local std::vector<SDL_Point> points;
+    points.resize(offsets.size());
+
+    const Uint8* jitter = jitterTable.data();
+    int range = std::max(distortionAmount * 2, 1);
+    for (size_t i = 0; i < offsets.size(); i++) {
+        int distortionX = jitter[cursor++ & (jitterTableSize - 1)] % range - distortionAmount;
+        int distortionY = jitter[cursor++ & (jitterTableSize - 1)] % range - distortionAmount;
+        points[i] = { x + offsets[i].x + distortionX, y + offsets[i].y + distortionY };
+    }
+    drawPoints(canvas, points.data(), int(points.size()), color);
+}
+
+// Puntos del borde de un círculo de radio dado, calculados una vez por radio
+const std::vector<SDL_Point>& getRingOffsets(int radius) {
+    static thread_local std::unordered_map<int, std::vector<SDL_Point>> rings;
+    auto found = rings.find(radius);
+    if (found != rings.end()) return found->second;
+
+    std::vector<SDL_Point>& offsets = rings[radius];
+    for (int w = -radius; w <= radius; w++) {
+        for (int h = -radius; h <= radius; h++) {
+            if (w * w + h * h <= radius * radius && w * w + h * h > (radius - 1) * (radius - 1)) {
+                offsets.push_back({ w, h });
+            }
+        }
+    }
+    return offsets;
+}
+
+// Puntos de una línea horizontal de largo y grosor dados, calculados una vez
+const std::vector<SDL_Point>& getLineOffsets(int length, int thickness) {
+    static thread_local std::unordered_map<Uint32, std::vector<SDL_Point>> lines;
+    Uint32 key = (Uint32(length) << 16) | Uint32(thickness);
+    auto found = lines.find(key);
+    if (found != lines.end()) return found->second;
+
+    std::vector<SDL_Point>& offsets = lines[key];
+    for (int x = -length / 2; x <= length / 2; x++) {
+        for (int y = -thickness / 2; y <= thickness / 2; y++) {
+            offsets.push_back({ x, y });
+        }
+    }
+    return offsets;
+}
+
+// Función para dibujar un círculo delgado; step es el paso de simulación que se dibuja
+void drawThinCircle(Canvas& canvas, int x, int y, int radius, SDL_Color color, int distortionAmount, Uint32 step) {
+    // Dibujar solo los puntos en el borde del círculo, cada uno con distorsión
+    drawJitteredPoints(canvas, x, y, getRingOffsets(radius), color, distortionAmount, jitterCursor(step, Uint32(radius)));
+}
+
+void drawThinLine(Canvas& canvas, int centerX, int centerY, int length, int thickness, SDL_Color color, int distortionAmount, Uint32 step) {
+    // Dibujar la l�nea horizontal con distorsi�n
+    drawJitteredPoints(canvas, centerX, centerY, getLineOffsets(length, thickness), color, distortionAmount,
+                       jitterCursor(step, 0x10000u + Uint32(length)));
+}
+
+void drawAccretionDisk(Canvas& canvas, Uint32 step) {
+    SDL_Color diskColor = {255, 165, 0, 255};  // Naranja
+    int diskLength = 200;  // Longitud del disco
+    int diskThickness = 7; // Grosor del disco
+    int distortionAmount = 3;  // Cantidad de distorsi�n
+
+    // Dibujar el disco de acreci�n frente al agujero negro
+    drawThinLine(canvas, 320, 240, diskLength, diskThickness, diskColor, distortionAmount, step);
+}
+
+const int blackHoleRadius = 50;  // Radio del agujero negro (centro completamente negro)
+
+// Capa estática del agujero negro: el disco negro no cambia nunca, así que se
+// rasteriza una vez y se compone en cada cuadro
+Sprite blackHoleCore;
+
+// Rasterizar el núcleo del agujero negro (todos los puntos con w² + h² <= r²) y
+// generar la tabla de distorsión con la semilla vigente
+void initBlackHole(Canvas& canvas) {
+    blackHoleCore = createSprite(blackHoleRadius * 2 + 1, blackHoleRadius * 2 + 1, blackHoleRadius, blackHoleRadius);
+    Canvas target = spriteCanvas(blackHoleCore);
+    std::vector<SDL_Rect> spans;
+    for (int h = -blackHoleRadius; h <= blackHoleRadius; h++) {
+        int halfWidth = 0;
+        while ((halfWidth + 1) * (halfWidth + 1) + h * h <= blackHoleRadius * blackHoleRadius) halfWidth++;
+        spans.push_back({ blackHoleRadius - halfWidth, blackHoleRadius + h, halfWidth * 2 + 1, 1 });
+    }
+    fillRects(target, spans.data(), int(spans.size()), {0, 0, 0, 255});  // Color negro sólido
+    uploadSprite(canvas, blackHoleCore);
+    initJitterTable();
+}
+
+// Liberar la capa estática del agujero negro
+void releaseBlackHole() {
+    releaseSprite(blackHoleCore);
+}
+
+// Versión original del núcleo: redibuja el disco completo para cada radio de 0
+// a blackHoleRadius. Se conserva solo como referencia para el benchmark.
+void drawBlackHoleCorePerRadius(Canvas& canvas, int centerX, int centerY) {
+    static thread_local std::vector<SDL_Point> corePoints;
+    for (int r = 0; r <= blackHoleRadius; r++) {
+        corePoints.clear();
+        for (int w = -r; w <= r; w++) {
+            for (int h = -r; h <= r; h++) {
+                if (w * w + h * h <= r * r) {  // Verifica que el punto esté dentro del círculo
+                    corePoints.push_back({ centerX + w, centerY + h });
+                }
+            }
+        }
+        drawPoints(canvas, corePoints.data(), int(corePoints.size()), {0, 0, 0, 255});  // Color negro sólido
+    }
+}
+
+// Dibujar los aros delgados y distorsionados alrededor del agujero negro
+void drawAccretionRings(Canvas& canvas, int centerX, int centerY, Uint32 step) {
+    int accretionDiskInnerRadius = 60;     // Radio interior del disco de acreción
+    int accretionDiskOuterRadius = 80;    // Radio exterior del disco de acreción
+    int distortionAmount = 2;              // Cantidad de distorsión para simular inestabilidad
+
+    for (int r = accretionDiskInnerRadius; r <= accretionDiskOuterRadius; r += 5) {
+        // Colores cálidos: amarillo a naranja
+        int red = 255;
+        int green = 165 + (r % 50);  // Degradado para obtener tonos naranja y amarillo
+        int blue = 0;
+        int alpha = 255 - (r - accretionDiskInnerRadius) * 2;  // Degradado de opacidad
+
+        // Dibujar cada círculo de luz delgado con distorsión
+        drawThinCircle(canvas, centerX, centerY, r, {Uint8(red), Uint8(green), Uint8(blue), Uint8(alpha)}, distortionAmount, step);
+    }
+}
+
+// Función para dibujar un agujero negro con un disco de acreción inestable; la
+// distorsión cambia con step, el paso de simulación que se dibuja
+void drawBlackHole(Canvas& canvas, int centerX, int centerY, Uint32 step) {
+    // 1. Dibujar el agujero negro en el centro (capa estática pre-rasterizada)
+    drawSprite(canvas, blackHoleCore, centerX, centerY);
+
+    // 2. Dibujar los aros delgados y distorsionados (disco de acreción)
+    drawAccretionRings(canvas, centerX, centerY, step);
+    
+    drawAccretionDisk(canvas, step);
+}
+
+// Función para actualizar la estrella i
+inline void updateStar(Star& star, size_t i, Uint32 step) {
+    star.y += star.speed;
+    if (star.y >= 480) {
+        star.y = 0;
+        star.x = streamRandom(StreamStars, (Uint64(step) << 32) | i).below(640);
+        star.previousY = star.y;  // Sin interpolar el salto
+    }
+}
+
+// Función para actualizar estrellas
+template <typename Policy>
+void updateStars(Policy, std::vector<Star>& stars, Uint32 step) {
+    Policy::forEach(stars.size(), 1024, [&](size_t i) {
+        updateStar(stars[i], i, step);
+    });
+}
+
+void updateStars(std::vector<Star>& stars, Uint32 step) {
+    withStagePolicy(LoopStars, [&](auto policy) { updateStars(policy, stars, step); });
+}
+
+// Función para dibujar estrellas, interpoladas entre los dos últimos pasos
+void drawStars(Canvas& canvas, const std::vector<Star>& stars, float alpha) {
+    parallelDraw(canvas, LoopDrawStars, stars.size(), [&](Canvas& target, size_t i) {
+        int y = interpolate(stars[i].previousY, stars[i].y, alpha);
+        drawCircle(target, stars[i].x, y, stars[i].size, {255, 255, 255});
+    });
+}
+
+// Función para iniciar una explosión
+void startExplosion(Explosion& explosion, int x, int y) {
+    explosion.x = x;
+    explosion.y = y;
+    explosion.radiusOrange = 1;    // Comienza con un radio pequeño
+    explosion.radiusYellow = 0;    // El círculo amarillo tiene un pequeño retraso
+    explosion.radiusWhite = 0;     // El círculo blanco tiene más retraso
+    explosion.maxRadius = 30;      // Radio máximo de la explosión
+    explosion.isActive = true;     // Activar la explosión
+}
+
+void initExplosionPool(ExplosionPool& pool, int capacity) {
+    pool.slots.assign(capacity, Explosion());
+    pool.active.clear();
+    pool.active.reserve(capacity);
+    pool.freeSlots.resize(capacity);
+    for (int i = 0; i < capacity; i++) pool.freeSlots[i] = capacity - 1 - i;  // La ranura 0 sale primero
+    pool.dropped = 0;
+}
+
+// Iniciar una explosión en una ranura libre. Con el grupo lleno la explosión se
+// descarta, en vez de reiniciar una animación en curso.
+bool spawnExplosion(ExplosionPool& pool, int x, int y) {
+    if (pool.freeSlots.empty()) {
+        pool.dropped++;
+        return false;
+    }
+    int slot = pool.freeSlots.back();
+    pool.freeSlots.pop_back();
+    startExplosion(pool.slots[slot], x, y);
+    pool.active.push_back(slot);
+    return true;
+}
+
+// Devolver a la pila las ranuras de las explosiones que terminaron, sin cambiar
+// el orden de las que siguen activas
+void releaseFinishedExplosions(ExplosionPool& pool) {
+    size_t kept = 0;
+    for (int slot : pool.active) {
+        if (pool.slots[slot].isActive) {
+            pool.active[kept++] = slot;
+        } else {
+            pool.freeSlots.push_back(slot);
+        }
+    }
+    pool.active.resize(kept);
+}
+
+// Función para actualizar una explosión (hacer crecer sus círculos)
+void updateExplosion(Explosion& explosion) {
+    if (explosion.isActive) {
+        // Desactivar la explosión cuando todos los radios alcanzaron su tamaño
+        // máximo (el último cuadro ya se dibujó con ese tamaño)
+        if (explosion.radiusWhite >= explosion.maxRadius) {
+            explosion.isActive = false;
+            return;
+        }
+
+        // Incrementar el tamaño de los círculos
+        if (explosion.radiusOrange < explosion.maxRadius) {
+            explosion.radiusOrange += 2;  // Círculo naranja crece más rápido
+        }
+        if (explosion.radiusOrange > 5 && explosion.radiusYellow < explosion.maxRadius) {
+            explosion.radiusYellow += 2;  // Círculo amarillo comienza un poco después
+        }
+        if (explosion.radiusYellow > 10 && explosion.radiusWhite < explosion.maxRadius) {
+            explosion.radiusWhite += 2;  // Círculo blanco comienza después del amarillo
+        }
+    }
+}
+
+// Función para dibujar una explosión con degradado de tres colores
+void drawExplosion(Canvas& canvas, const Explosion& explosion) {
+    if (explosion.isActive) {
+        // Dibujar el círculo naranja (capa más externa)
+        drawCircle(canvas, explosion.x, explosion.y, explosion.radiusOrange, {255, 69, 0, 255});
+
+        // Dibujar el círculo amarillo (capa intermedia)
+        if (explosion.radiusYellow > 0) {
+            drawCircle(canvas, explosion.x, explosion.y, explosion.radiusYellow, {255, 255, 0, 255});
+        }
+
+        // Dibujar el círculo blanco (capa más interna)
+        if (explosion.radiusWhite > 0) {
+            drawCircle(canvas, explosion.x, explosion.y, explosion.radiusWhite, {255, 255, 255, 255});
+        }
+    }
+}
+
+template <typename Policy>
+void updatePlanets(Policy, std::vector<Planet>& planets, PlanetPositions& positions, Uint32 currentTime){
+    Policy::forEach(planets.size(), 256, [&](size_t i) {
+        updatePlanet(planets[i], currentTime);
+        storePlanetPosition(positions, i, planets[i]);
+    });
+}
+
+void updatePlanets(std::vector<Planet>& planets, PlanetPositions& positions, Uint32 currentTime){
+    withStagePolicy(LoopPlanets, [&](auto policy) { updatePlanets(policy, planets, positions, currentTime); });
+}
+
+void drawPlanets(Canvas& canvas, const std::vector<Planet>& planets, const PlanetPositions& positions, float alpha){
+    parallelDraw(canvas, LoopDrawPlanets, planets.size(), [&](Canvas& target, size_t i) {
+        drawPlanet(target, planets[i], interpolate(positions.previousX[i], positions.x[i], alpha),
+                   interpolate(positions.previousY[i], positions.y[i], alpha));
+    });
+}
+
+// Modo gravedad (--gravedad): los puntos de la nebulosa, los asteroides y los
+// planetas visibles se atraen entre sí. La fuerza se aproxima con un quadtree de
+// Barnes-Hut: un nodo lejano (lado < theta * distancia) actúa como una sola masa
+// en su centro de masa, así que el costo es O(N log N) en vez de O(N²). La
+// atracción constante de la nebulosa hacia el centro se mantiene como la del
+// agujero negro. Los planetas siguen en sus órbitas: atraen pero no se desvían.
+bool gravityEnabled = false;
+float gravityTheta = 0.5f;               // Ángulo de apertura (--theta); 0 = suma exacta
+
+const float gravityConstant = 0.5f;
+const float gravitySoftening = 8.0f;     // Evita fuerzas enormes entre cuerpos muy cercanos
+const float nebulaTotalMass = 1000.0f;   // Repartida entre todos los puntos de la nebulosa
+const float asteroidMassPerSize = 2.0f;
+const float planetMassPerSize = 20.0f;
+const float maxAsteroidSpeed = 6.0f;
+
+// Cuerpos de un paso (SoA): posición, masa y aceleración resultante
+struct GravityBodies {
+    std::vector<float> x, y, mass;
+    std::vector<float> accelX, accelY;
+};
+
+// Nodo del quadtree. Los hijos no vacíos quedan contiguos en nodes y cada nodo
+// cubre un rango contiguo de cuerpos en el orden de Morton.
+struct QuadNode {
+    float massX, massY;          // Centro de masa
+    float mass;
+    float size;                  // Lado del cuadrado del nodo
+    int firstChild, childCount;  // childCount = 0 en las hojas
+    int begin, end;              // Rango en QuadTree::order
+};
+
+const int quadLeafSize = 8;
+const int quadMaxLevel = 16;       // Bits por eje del código de Morton
+const int quadTaskCutoff = 4096;   // Rangos más chicos se construyen sin crear tareas
+const int quadSortCutoff = 16384;
+
+struct QuadTree {
+    float minX, minY, size;            // Cuadrado que contiene a todos los cuerpos
+    std::vector<Uint64> sortedKeys;    // Código de Morton (32 bits altos) e índice del cuerpo
+    std::vector<int> order;            // Índices de los cuerpos en orden de Morton
+    std::vector<QuadNode> nodes;
+    std::atomic<int> nodeCount;
+};
+
+GravityBodies gravityBodies;
+QuadTree gravityTree;
+
+// Intercalar los bits de x e y (16 bits cada uno) en un código de Morton
+inline Uint32 mortonCode(Uint32 x, Uint32 y) {
+    auto spread = [](Uint32 v) {
+        v = (v | (v << 8)) & 0x00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u;
+        v = (v | (v << 1)) & 0x55555555u;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+// Ordenamiento por mezcla con una tarea por mitad
+void sortKeysTask(Uint64* begin, Uint64* end) {
+    if (end - begin <= quadSortCutoff) {
+        std::sort(begin, end);
+        return;
+    }
+    Uint64* middle = begin + (end - begin) / 2;
+    #pragma omp task
+    sortKeysTask(begin, middle);
+    sortKeysTask(middle, end);
+    #pragma omp taskwait
+    std::inplace_merge(begin, middle, end);
+}
+
+void buildQuadNode(QuadTree& tree, const GravityBodies& bodies, int nodeIndex, int begin, int end, int level) {
+    QuadNode& node = tree.nodes[nodeIndex];
+    node.size = tree.size / float(1 << level);
+    node.begin = begin;
+    node.end = end;
+    node.firstChild = node.childCount = 0;
+
+    if (end - begin > quadLeafSize && level < quadMaxLevel) {
+        // Los cuerpos están ordenados por código, así que cada cuadrante (los
+        // 2 bits de este nivel) es un subrango contiguo
+        int shift = 32 + 2 * (quadMaxLevel - 1 - level);
+        int bounds[5] = { begin, 0, 0, 0, end };
+        for (int quadrant = 1; quadrant < 4; quadrant++) {
+            bounds[quadrant] = int(std::partition_point(tree.sortedKeys.begin() + bounds[quadrant - 1], tree.sortedKeys.begin() + end,
+                                                        [&](Uint64 key) { return int((key >> shift) & 3) < quadrant; }) -
+                                   tree.sortedKeys.begin());
+        }
+        for (int quadrant = 0; quadrant < 4; quadrant++) node.childCount += bounds[quadrant] < bounds[quadrant + 1];
+        node.firstChild = tree.nodeCount.fetch_add(node.childCount);
+
+        int child = node.firstChild;
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            int childBegin = bounds[quadrant], childEnd = bounds[quadrant + 1];
+            if (childBegin == childEnd) continue;
+            if (childEnd - childBegin > quadTaskCutoff) {
+                #pragma omp task shared(tree, bodies)
+                buildQuadNode(tree, bodies, child, childBegin, childEnd, level + 1);
+            } else {
+                buildQuadNode(tree, bodies, child, childBegin, childEnd, level + 1);
+            }
+            child++;
+        }
+        #pragma omp taskwait
+
+        // Masa y centro de masa a partir de los hijos
+        float mass = 0, weightedX = 0, weightedY = 0;
+        for (int c = node.firstChild; c < node.firstChild + node.childCount; c++) {
+            const QuadNode& childNode = tree.nodes[c];
+            mass += childNode.mass;
+            weightedX += childNode.mass * childNode.massX;
+            weightedY += childNode.mass * childNode.massY;
+        }
+        node.mass = mass;
+        node.massX = weightedX / mass;
+        node.massY = weightedY / mass;
+        return;
+    }
+
+    // Hoja: masa de sus cuerpos
+    float mass = 0, weightedX = 0, weightedY = 0;
+    for (int k = begin; k < end; k++) {
+        int i = tree.order[k];
+        mass += bodies.mass[i];
+        weightedX += bodies.mass[i] * bodies.x[i];
+        weightedY += bodies.mass[i] * bodies.y[i];
+    }
+    node.mass = mass;
+    node.massX = weightedX / mass;
+    node.massY = weightedY / mass;
+}
+
+// Construir el quadtree: códigos de Morton, ordenamiento y nodos, con tareas de OpenMP
+void buildQuadTree(QuadTree& tree, const GravityBodies& bodies) {
+    int count = bodies.x.size();
+    tree.order.resize(count);
+    tree.sortedKeys.resize(count);
+    tree.nodeCount = 1;
+    if (count == 0) return;
+
+    float minX = bodies.x[0], minY = bodies.y[0], maxX = minX, maxY = minY;
+    #pragma omp parallel for reduction(min: minX, minY) reduction(max: maxX, maxY)
+    for (int i = 0; i < count; i++) {
+        minX = std::min(minX, bodies.x[i]);
+        minY = std::min(minY, bodies.y[i]);
+        maxX = std::max(maxX, bodies.x[i]);
+        maxY = std::max(maxY, bodies.y[i]);
+    }
+    tree.minX = minX;
+    tree.minY = minY;
+    tree.size = std::max({ maxX - minX, maxY - minY, 1.0f }) * 1.0001f;  // Que el borde máximo quede adentro
+
+    float scale = 65536.0f / tree.size;
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++) {
+        Uint32 cellX = std::min(65535u, Uint32((bodies.x[i] - tree.minX) * scale));
+        Uint32 cellY = std::min(65535u, Uint32((bodies.y[i] - tree.minY) * scale));
+        tree.sortedKeys[i] = (Uint64(mortonCode(cellX, cellY)) << 32) | Uint32(i);
+    }
+
+    // Cada nivel reparte cuerpos disjuntos entre nodos internos de más de
+    // quadLeafSize cuerpos, y cada hoja tiene al menos uno: esto acota los nodos
+    size_t maxNodes = size_t(count) + size_t(quadMaxLevel) * count / (quadLeafSize + 1) + 1;
+    if (tree.nodes.size() < maxNodes) tree.nodes.resize(maxNodes);
+
+    #pragma omp parallel
+    #pragma omp single
+    {
+        sortKeysTask(tree.sortedKeys.data(), tree.sortedKeys.data() + count);
+        #pragma omp taskloop grainsize(4096)
+        for (int k = 0; k < count; k++) tree.order[k] = int(tree.sortedKeys[k] & 0xFFFFFFFFu);
+        buildQuadNode(tree, bodies, 0, 0, count, 0);
+    }
+}
+
+// Aceleración de cada cuerpo recorriendo el árbol. Los cuerpos se recorren en
+// orden de Morton para que cuerpos vecinos visiten los mismos nodos.
+void computeGravity(const QuadTree& tree, GravityBodies& bodies, float theta) {
+    int count = bodies.x.size();
+    bodies.accelX.resize(count);
+    bodies.accelY.resize(count);
+    if (count == 0) return;
+    float thetaSquared = theta * theta;
+    float softeningSquared = gravitySoftening * gravitySoftening;
+
+    #pragma omp parallel
+    #pragma omp single
+    #pragma omp taskloop grainsize(256)
+    for (int k = 0; k < count; k++) {
+        int i = tree.order[k];
+        float x = bodies.x[i], y = bodies.y[i];
+        float accelX = 0, accelY = 0;
+        auto attract = [&](float sourceX, float sourceY, float mass) {
+            float deltaX = sourceX - x, deltaY = sourceY - y;
+            float distanceSquared = deltaX * deltaX + deltaY * deltaY + softeningSquared;
+            float strength = mass / (distanceSquared * std::sqrt(distanceSquared));
+            accelX += strength * deltaX;
+            accelY += strength * deltaY;
+        };
+
+        int stack[4 * quadMaxLevel + 4];  // A lo sumo 3 hermanos pendientes por nivel
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const QuadNode& node = tree.nodes[stack[--top]];
+            float deltaX = node.massX - x, deltaY = node.massY - y;
+            if (node.childCount == 0) {
+                for (int j = node.begin; j < node.end; j++) {
+                    int other = tree.order[j];
+                    if (other != i) attract(bodies.x[other], bodies.y[other], bodies.mass[other]);
+                }
+            } else if (node.size * node.size < thetaSquared * (deltaX * deltaX + deltaY * deltaY)) {
+                attract(node.massX, node.massY, node.mass);  // Nodo lejano: una sola masa
+            } else {
+                for (int c = node.firstChild + node.childCount - 1; c >= node.firstChild; c--) stack[top++] = c;
+            }
+        }
+        bodies.accelX[i] = gravityConstant * accelX;
+        bodies.accelY[i] = gravityConstant * accelY;
+    }
+}
+
+// Paso de gravedad del mundo: juntar los cuerpos, construir el árbol, calcular
+// las aceleraciones y sumarlas a las velocidades de la nebulosa y los asteroides
+void applyGravity(World& world) {
+    Nebula& nebula = world.nebula;
+    int numNebula = nebula.x.size(), numAsteroids = world.asteroids.size(), numPlanets = world.planets.size();
+    GravityBodies& bodies = gravityBodies;
+    bodies.x.resize(numNebula + numAsteroids + numPlanets);
+    bodies.y.resize(bodies.x.size());
+    bodies.mass.resize(bodies.x.size());
+
+    float nebulaMass = numNebula > 0 ? nebulaTotalMass / numNebula : 0;
+    #pragma omp parallel for
+    for (int i = 0; i < numNebula; i++) {
+        bodies.x[i] = nebula.x[i];
+        bodies.y[i] = nebula.y[i];
+        bodies.mass[i] = nebulaMass;
+    }
+    int count = numNebula;
+    for (const Asteroid& asteroid : world.asteroids) {
+        bodies.x[count] = asteroid.exactX;
+        bodies.y[count] = asteroid.exactY;
+        bodies.mass[count++] = asteroidMassPerSize * asteroid.size;
+    }
+    for (int i = 0; i < numPlanets; i++) {
+        if (!world.planets[i].isVisible) continue;
+        bodies.x[count] = world.planetPositions.x[i];
+        bodies.y[count] = world.planetPositions.y[i];
+        bodies.mass[count++] = planetMassPerSize * world.planets[i].size;
+    }
+    bodies.x.resize(count);
+    bodies.y.resize(count);
+    bodies.mass.resize(count);
+
+    buildQuadTree(gravityTree, bodies);
+    computeGravity(gravityTree, bodies, gravityTheta);
+
+    #pragma omp parallel for
+    for (int i = 0; i < numNebula; i++) {
+        nebula.dx[i] += bodies.accelX[i];
+        nebula.dy[i] += bodies.accelY[i];
+
+        // Un encuentro cercano puede lanzar el punto fuera de la pantalla: regenerarlo
+        if (nebula.x[i] < 0 || nebula.x[i] >= 640 || nebula.y[i] < 0 || nebula.y[i] >= 480) {
+            respawnNebulaPoint(nebula, i, world.step);
+        }
+    }
+    for (int i = 0; i < numAsteroids; i++) {
+        world.asteroids[i].velocityX += bodies.accelX[numNebula + i];
+        world.asteroids[i].velocityY += bodies.accelY[numNebula + i];
+    }
+}
+
+// Asteroide en el modo gravedad: posición y velocidad continuas (la gravedad ya
+// sumó su aceleración), con la rapidez acotada y rebote en los bordes
+void updateAsteroidGravity(Asteroid& asteroid) {
+    float speed = std::sqrt(asteroid.velocityX * asteroid.velocityX + asteroid.velocityY * asteroid.velocityY);
+    if (speed > maxAsteroidSpeed) {
+        asteroid.velocityX *= maxAsteroidSpeed / speed;
+        asteroid.velocityY *= maxAsteroidSpeed / speed;
+    }
+    asteroid.exactX += asteroid.velocityX;
+    asteroid.exactY += asteroid.velocityY;
+    if (asteroid.exactX <= 0 || asteroid.exactX >= 640) {
+        asteroid.velocityX = -asteroid.velocityX;
+        asteroid.exactX = std::min(std::max(asteroid.exactX, 0.0f), 640.0f);
+    }
+    if (asteroid.exactY <= 0 || asteroid.exactY >= 480) {
+        asteroid.velocityY = -asteroid.velocityY;
+        asteroid.exactY = std::min(std::max(asteroid.exactY, 0.0f), 480.0f);
+    }
+    asteroid.x = int(asteroid.exactX);
+    asteroid.y = int(asteroid.exactY);
+}
+
+template <typename Policy>
+void updateAsteroids(Policy, std::vector<Asteroid>& asteroids){
+    Policy::forEach(asteroids.size(), 1024, [&](size_t i) {
+        if (gravityEnabled) {
+            updateAsteroidGravity(asteroids[i]);
+        } else {
+            updateAsteroid(asteroids[i]);
+        }
+    });
+}
+
+void updateAsteroids(std::vector<Asteroid>& asteroids){
+    withStagePolicy(LoopAsteroids, [&](auto policy) { updateAsteroids(policy, asteroids); });
+}
+
+void drawAsteroids(Canvas& canvas, const std::vector<Asteroid>& asteroids, float alpha){
+    parallelDraw(canvas, LoopDrawAsteroids, asteroids.size(), [&](Canvas& target, size_t i) {
+        drawAsteroid(target, asteroids[i], alpha);
+    });
+}
+
+template <typename Policy>
+void updateAllExplosions(Policy, ExplosionPool& explosions){
+    Policy::forEach(explosions.active.size(), 16, [&](size_t i) {
+        updateExplosion(explosions.slots[explosions.active[i]]);
+    });
+    releaseFinishedExplosions(explosions);
+}
+
+void updateAllExplosions(ExplosionPool& explosions){
+    withStagePolicy(LoopExplosions, [&](auto policy) { updateAllExplosions(policy, explosions); });
+}
+
+void drawAllExplosions(Canvas& canvas, const ExplosionPool& explosions){
+    parallelDraw(canvas, LoopDrawExplosions, explosions.active.size(), [&](Canvas& target, size_t i) {
+        drawExplosion(target, explosions.slots[explosions.active[i]]);
+    });
+}
+
+// Prueba exacta entre un asteroide y un planeta cuya posición ya se calculó
+inline bool overlapsPlanet(const Asteroid& asteroid, int planetX, int planetY, int planetSize) {
+    int deltaX = asteroid.x - planetX;
+    int deltaY = asteroid.y - planetY;
+    int distance = sqrt(deltaX * deltaX + deltaY * deltaY);
+    return distance < (planetSize + asteroid.size);
+}
+
+// Cuerpo guardado en una grilla de colisiones
+struct GridBody {
+    int x, y, size;
+    bool present;  // false para dejarlo fuera (por ejemplo, un planeta invisible)
+};
+
+// Grilla uniforme para la fase amplia de las colisiones. Se reconstruye cada
+// paso con un ordenamiento por conteo: items guarda los índices de los cuerpos
+// agrupados por celda y cellStart dónde empieza cada celda, así que cada consulta
+// solo prueba los cuerpos de las celdas que cubre. Si los cuerpos están tan
+// dispersos que la grilla superaría maxCollisionCells, las celdas se agrandan.
+const int collisionCellSize = 32;
+const size_t maxCollisionCells = 1 << 20;
+
+struct CollisionGrid {
+    int minX, minY;                // Esquina de la caja que contiene a todos los cuerpos
+    int cellSize;                  // collisionCellSize, o un múltiplo si la caja es muy grande
+    int columns, rows;
+    int maxSize;                   // Tamaño del cuerpo más grande (amplía la búsqueda)
+    std::vector<int> cellStart;    // columns * rows + 1 entradas
+    std::vector<int> cursor;       // Posición de escritura de cada celda al construir
+    std::vector<int> items;        // Índices de los cuerpos ordenados por celda
+};
+
+CollisionGrid asteroidGrid;
+
+// bodyOf(i) devuelve el GridBody del cuerpo i, para i en [0, count)
+template <typename BodyOf>
+void buildCollisionGrid(CollisionGrid& grid, size_t count, BodyOf bodyOf) {
+    bool empty = true;
+    int maxX = 0, maxY = 0;
+    grid.minX = grid.minY = 0;
+    grid.maxSize = 0;
+    for (size_t i = 0; i < count; i++) {
+        GridBody body = bodyOf(i);
+        if (!body.present) continue;
+        if (empty) {
+            grid.minX = maxX = body.x;
+            grid.minY = maxY = body.y;
+            empty = false;
+        }
+        grid.minX = std::min(grid.minX, body.x);
+        grid.minY = std::min(grid.minY, body.y);
+        maxX = std::max(maxX, body.x);
+        maxY = std::max(maxY, body.y);
+        grid.maxSize = std::max(grid.maxSize, body.size);
+    }
+    grid.cellSize = collisionCellSize;
+    while (size_t((maxX - grid.minX) / grid.cellSize + 1) * size_t((maxY - grid.minY) / grid.cellSize + 1) > maxCollisionCells) {
+        grid.cellSize *= 2;
+    }
+    grid.columns = (maxX - grid.minX) / grid.cellSize + 1;
+    grid.rows = (maxY - grid.minY) / grid.cellSize + 1;
+
+    auto cellOf = [&](const GridBody& body) {
+        return (body.y - grid.minY) / grid.cellSize * grid.columns + (body.x - grid.minX) / grid.cellSize;
+    };
+    grid.cellStart.assign(size_t(grid.columns) * grid.rows + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        GridBody body = bodyOf(i);
+        if (body.present) grid.cellStart[cellOf(body) + 1]++;
+    }
+    for (size_t cell = 1; cell < grid.cellStart.size(); cell++) grid.cellStart[cell] += grid.cellStart[cell - 1];
+    grid.cursor.assign(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    grid.items.resize(grid.cellStart.back());
+    for (size_t i = 0; i < count; i++) {
+        GridBody body = bodyOf(i);
+        if (body.present) grid.items[grid.cursor[cellOf(body)]++] = int(i);
+    }
+}
+
+// Llamar a visit(i) con cada cuerpo de las celdas que cubre el círculo de radio
+// size + maxSize alrededor de (x, y), solo en las filas [firstRow, lastRow] de
+// la grilla. Se detiene en cuanto visit devuelve true, y en ese caso devuelve true.
+template <typename Visit>
+bool visitNearby(const CollisionGrid& grid, int x, int y, int size, Visit visit, int firstRow = 0, int lastRow = INT_MAX) {
+    int reach = size + grid.maxSize;
+    int firstColumn = std::max(0, (x - reach - grid.minX) / grid.cellSize);
+    int lastColumn = std::min(grid.columns - 1, (x + reach - grid.minX) / grid.cellSize);
+    firstRow = std::max(firstRow, (y - reach - grid.minY) / grid.cellSize);
+    lastRow = std::min({ lastRow, grid.rows - 1, (y + reach - grid.minY) / grid.cellSize });
+    if (x + reach < grid.minX || y + reach < grid.minY) return false;  // La división trunca hacia 0
+    if (firstColumn > lastColumn || firstRow > lastRow) return false;  // Fuera de la caja
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        int begin = grid.cellStart[row * grid.columns + firstColumn];
+        int end = grid.cellStart[row * grid.columns + lastColumn + 1];  // Las celdas de una fila son contiguas
+        for (int k = begin; k < end; k++) {
+            if (visit(grid.items[k])) return true;
+        }
+    }
+    return false;
+}
+
+// Versión anterior, todos contra todos. Se conserva para --bench-colisiones.
+// Es secuencial: sirve de referencia y el grupo de explosiones no admite hilos.
+void checkAllCollisionsBruteForce(std::vector<Planet>& planets, const PlanetPositions& positions, std::vector<Asteroid>& asteroids, ExplosionPool& explosions, Uint32 currentTime){
+    for (size_t i = 0; i < planets.size(); i++) {
+        int planetX = positions.x[i];
+        int planetY = positions.y[i];
+        for (auto& asteroid : asteroids) {
+            if (planets[i].isVisible && overlapsPlanet(asteroid, planetX, planetY, planets[i].size)) {
+                spawnExplosion(explosions, planetX, planetY);
+                planets[i].isVisible = false;
+                planets[i].respawnTime = currentTime + 5000; // Desaparece durante 5 segundos
+            }
+        }
+    }
+}
+
+// Colisión entre un planeta y un asteroide. La detección solo lee el mundo y
+// cada iteración anota sus choques en su propia ranura, sin listas compartidas
+// ni sincronización; los eventos se unen en orden de planeta y asteroide y los
+// efectos se aplican después en un solo hilo, así que el resultado es el mismo
+// con cualquier política, número de hilos y reparto.
+struct CollisionEvent {
+    int planet, asteroid;
+};
+
+// Eje sobre el que se reparte la detección entre los hilos
+enum CollisionAxis { AxisPlanets, AxisAsteroids, AxisBoth, AxisCount };
+const char* const collisionAxisNames[AxisCount] = { "planetas", "asteroides", "ambos" };
+CollisionAxis collisionAxis = AxisPlanets;  // Se elige con --colisiones
+
+CollisionGrid planetGrid;
+std::vector<int> collisionSlots;   // Primer asteroide que toca cada planeta (o par planeta × fila), o -1
+std::vector<int> collisionCounts;  // Eje asteroides: inicio de los choques de cada asteroide en mergedCollisions
+std::vector<CollisionEvent> mergedCollisions;
+
+// Las partes secuenciales (la grilla, la suma de prefijos, la compactación y el
+// orden) pasan por Policy::serial, así que la misma función sirve dentro de la
+// región única con TeamPolicy.
+template <typename Policy>
+void detectCollisions(Policy, const std::vector<Planet>& planets, const PlanetPositions& positions, const std::vector<Asteroid>& asteroids, CollisionAxis axis) {
+    // Ordenar los eventos para que el orden de los efectos no dependa del eje
+    auto sortEvents = []() {
+        std::sort(mergedCollisions.begin(), mergedCollisions.end(), [](const CollisionEvent& a, const CollisionEvent& b) {
+            return a.planet != b.planet ? a.planet < b.planet : a.asteroid < b.asteroid;
+        });
+    };
+
+    int numAsteroids = asteroids.size();
+    Policy::serial([&]() {
+        if (axis == AxisAsteroids) {
+            // Solo entran los planetas que alcanzan la caja de los asteroides: los
+            // demás no pueden chocar, y con órbitas cada vez más amplias la caja
+            // de todos los planetas crece con el cuadrado de su cantidad
+            int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN, maxSize = 0;
+            for (const Asteroid& asteroid : asteroids) {
+                minX = std::min(minX, asteroid.x);
+                minY = std::min(minY, asteroid.y);
+                maxX = std::max(maxX, asteroid.x);
+                maxY = std::max(maxY, asteroid.y);
+                maxSize = std::max(maxSize, asteroid.size);
+            }
+            buildCollisionGrid(planetGrid, planets.size(), [&](size_t i) {
+                int x = int(positions.x[i]), y = int(positions.y[i]), reach = planets[i].size + maxSize;
+                bool reachable = x + reach > minX && x - reach < maxX && y + reach > minY && y - reach < maxY;
+                return GridBody{ x, y, planets[i].size, planets[i].isVisible && reachable };
+            });
+            collisionCounts.assign(numAsteroids + 1, 0);
+        } else {
+            buildCollisionGrid(asteroidGrid, asteroids.size(), [&](size_t k) {
+                return GridBody{ asteroids[k].x, asteroids[k].y, asteroids[k].size, true };
+            });
+            collisionSlots.assign(planets.size() * (axis == AxisBoth ? asteroidGrid.rows : 1), -1);
+        }
+        mergedCollisions.clear();
+    });
+
+    if (axis == AxisAsteroids) {
+        // Cada asteroide consulta la grilla de planetas visibles. Un asteroide
+        // puede tocar varios planetas: primero se cuentan sus choques, y tras
+        // la suma de prefijos cada asteroide escribe en su propio rango.
+        Policy::forEach(numAsteroids, 256, [&](size_t k) {
+            int hits = 0;
+            visitNearby(planetGrid, asteroids[k].x, asteroids[k].y, asteroids[k].size, [&](int i) {
+                hits += overlapsPlanet(asteroids[k], positions.x[i], positions.y[i], planets[i].size);
+                return false;
+            });
+            collisionCounts[k + 1] = hits;
+        });
+        Policy::serial([&]() {
+            for (int k = 0; k < numAsteroids; k++) collisionCounts[k + 1] += collisionCounts[k];
+            mergedCollisions.resize(collisionCounts[numAsteroids]);
+        });
+        Policy::forEach(numAsteroids, 256, [&](size_t k) {
+            int next = collisionCounts[k];
+            if (next == collisionCounts[k + 1]) return;
+            visitNearby(planetGrid, asteroids[k].x, asteroids[k].y, asteroids[k].size, [&](int i) {
+                if (overlapsPlanet(asteroids[k], positions.x[i], positions.y[i], planets[i].size)) {
+                    mergedCollisions[next++] = { i, int(k) };
+                }
+                return false;
+            });
+        });
+        Policy::serial(sortEvents);
+    } else {
+        // Cada planeta (o cada par planeta × fila de la grilla de asteroides, que
+        // reparte ambos ejes) consulta la grilla; basta con un choque por ranura
+        size_t rowsPerPlanet = axis == AxisBoth ? asteroidGrid.rows : 1;
+        Policy::forEach(collisionSlots.size(), 64, [&](size_t slot) {
+            int i = slot / rowsPerPlanet;
+            if (!planets[i].isVisible) return;
+            int planetX = positions.x[i], planetY = positions.y[i];
+            int firstRow = axis == AxisBoth ? int(slot % rowsPerPlanet) : 0;
+            int lastRow = axis == AxisBoth ? firstRow : INT_MAX;
+            visitNearby(asteroidGrid, planetX, planetY, planets[i].size, [&](int k) {
+                if (!overlapsPlanet(asteroids[k], planetX, planetY, planets[i].size)) return false;
+                collisionSlots[slot] = k;
+                return true;
+            }, firstRow, lastRow);
+        });
+        Policy::serial([&]() {
+            for (size_t slot = 0; slot < collisionSlots.size(); slot++) {
+                if (collisionSlots[slot] >= 0) mergedCollisions.push_back({ int(slot / rowsPerPlanet), collisionSlots[slot] });
+            }
+            sortEvents();
+        });
+    }
+}
+
+// Aplicar los efectos de los choques detectados: el primer evento de cada planeta
+// inicia su explosión y lo oculta; los siguientes del mismo planeta no hacen nada
+void applyCollisions(std::vector<Planet>& planets, const PlanetPositions& positions, ExplosionPool& explosions, Uint32 currentTime) {
+    for (const CollisionEvent& event : mergedCollisions) {
+        Planet& planet = planets[event.planet];
+        if (!planet.isVisible) continue;
+        spawnExplosion(explosions, positions.x[event.planet], positions.y[event.planet]);
+        planet.isVisible = false;
+        planet.respawnTime = currentTime + 5000; // Desaparece durante 5 segundos
+    }
+}
+
+template <typename Policy>
+void checkAllCollisions(Policy policy, std::vector<Planet>& planets, const PlanetPositions& positions, std::vector<Asteroid>& asteroids, ExplosionPool& explosions, Uint32 currentTime){
+    detectCollisions(policy, planets, positions, asteroids, collisionAxis);
+    applyCollisions(planets, positions, explosions, currentTime);
+}
+
+void checkAllCollisions(std::vector<Planet>& planets, const PlanetPositions& positions, std::vector<Asteroid>& asteroids, ExplosionPool& explosions, Uint32 currentTime){
+    withStagePolicy(LoopCollisions, [&](auto policy) { checkAllCollisions(policy, planets, positions, asteroids, explosions, currentTime); });
+}
+
+// Perfilador por etapas. Cada etapa de la actualización y del dibujo suma sus
+// ticks del contador de alta resolución en el cuadro actual; al cerrar el cuadro
+// el total entra en una ventana móvil de los últimos profileWindow cuadros, con
+// un histograma logarítmico (8 intervalos por octava) del que salen los percentiles.
+enum ProfileStage {
+    StageSaveState, StageGravity, StageUpdateNebula, StageUpdateStars, StageUpdatePlanets,
+    StageUpdateExplosions, StageUpdateAsteroids, StageUpdateLoops, StageCollisions, StagePipelinePublish,
+    StageClear, StageDrawRecord, StageDrawNebula, StageDrawStars, StageDrawBlackHole, StageDrawPlanets,
+    StageDrawExplosions, StageDrawAsteroids, StageUpload, StagePresent, StageForkJoin, StageBarrier, StageCriticalPath, StageFrame,
+    StageCount
+};
+const char* const profileStageNames[StageCount] = {
+    "actualizar/estado anterior", "actualizar/gravedad", "actualizar/nebulosa", "actualizar/estrellas", "actualizar/planetas",
+    "actualizar/explosiones", "actualizar/asteroides", "actualizar/bucles fusionados", "actualizar/colisiones", "pipeline/publicar",
+    "dibujar/limpiar", "dibujar/grabar comandos", "dibujar/nebulosa", "dibujar/estrellas", "dibujar/agujero negro", "dibujar/planetas",
+    "dibujar/explosiones", "dibujar/asteroides", "dibujar/subir textura", "presentar", "región/fork-join", "región/barreras", "grafo/camino crítico", "cuadro completo"
+};
+
+const int profileWindow = 600;       // Cuadros en la ventana móvil (10 s a 60 FPS)
+const int profileBinsPerOctave = 8;
+const int profileBins = 24 * profileBinsPerOctave;  // De 1 µs a unos 16 s
+
+struct StageProfile {
+    std::atomic<Uint64> pendingTicks;  // Ticks acumulados en el cuadro actual (la simulación puede ir en otro hilo)
+    double samples[profileWindow];     // Microsegundos por cuadro, en anillo
+    int histogram[profileBins];
+    double sum;                        // Suma de las muestras de la ventana
+};
+
+struct FrameProfiler {
+    StageProfile stages[StageCount];
+    int count;                         // Muestras en la ventana
+    int next;                          // Siguiente posición del anillo
+};
+
+FrameProfiler frameProfiler;
+
+// Intervalo del histograma para una duración en microsegundos
+int profileBin(double microseconds) {
+    int bin = int(std::log2(1.0 + microseconds) * profileBinsPerOctave);
+    return std::min(std::max(bin, 0), profileBins - 1);
+}
+
+// Sumar a una etapa el tiempo desde start; devuelve el instante actual para
+// encadenar la siguiente etapa
+Uint64 recordStage(ProfileStage stage, Uint64 start) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    frameProfiler.stages[stage].pendingTicks += now - start;
+    return now;
+}
+
+// Cerrar el cuadro: pasar lo acumulado de cada etapa a la ventana móvil
+void finishProfileFrame() {
+    // La sobrecarga de las regiones se cuenta aparte; pasar lo nuevo desde el cuadro anterior
+    static RegionTotals seen = {};
+    RegionTotals now = regionTotals();
+    frameProfiler.stages[StageForkJoin].pendingTicks += now.forkJoinTicks - seen.forkJoinTicks;
+    frameProfiler.stages[StageBarrier].pendingTicks += now.barrierTicks - seen.barrierTicks;
+    seen = now;
+
+    double ticksPerMicrosecond = SDL_GetPerformanceFrequency() / 1e6;
+    int slot = frameProfiler.next;
+    bool full = frameProfiler.count == profileWindow;
+    for (StageProfile& stage : frameProfiler.stages) {
+        double sample = stage.pendingTicks.exchange(0) / ticksPerMicrosecond;
+        if (full) {
+            stage.sum -= stage.samples[slot];
+            stage.histogram[profileBin(stage.samples[slot])]--;
+        }
+        stage.samples[slot] = sample;
+        stage.sum += sample;
+        stage.histogram[profileBin(sample)]++;
+    }
+    frameProfiler.next = (slot + 1) % profileWindow;
+    if (!full) frameProfiler.count++;
+}
+
+// Percentil p (0 a 100) de una etapa, en microsegundos (límite superior del intervalo)
+double stagePercentile(const StageProfile& stage, double p) {
+    int target = std::max(1, int(std::ceil(p / 100.0 * frameProfiler.count)));
+    int seen = 0;
+    for (int bin = 0; bin < profileBins; bin++) {
+        seen += stage.histogram[bin];
+        if (seen >= target) return std::exp2(double(bin + 1) / profileBinsPerOctave) - 1.0;
+    }
+    return 0;
+}
+
+// Imprimir la tabla de la ventana móvil: media, p95, p99 y fracción del cuadro
+void printProfile() {
+    if (frameProfiler.count == 0) return;
+    double frameMean = frameProfiler.stages[StageFrame].sum / frameProfiler.count;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Perfil de los últimos " << frameProfiler.count << " cuadros (ms)" << std::endl;
+    std::cout << std::left << std::setw(28) << "Etapa" << std::right << std::setw(10) << "media"
+              << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "% cuadro" << std::endl;
+    for (int i = 0; i < StageCount; i++) {
+        const StageProfile& stage = frameProfiler.stages[i];
+        double mean = stage.sum / frameProfiler.count;
+        std::cout << std::left << std::setw(28) << profileStageNames[i] << std::right
+                  << std::setw(10) << mean / 1000.0
+                  << std::setw(10) << stagePercentile(stage, 95) / 1000.0
+                  << std::setw(10) << stagePercentile(stage, 99) / 1000.0
+                  << std::setprecision(1) << std::setw(10) << (frameMean > 0 ? 100.0 * mean / frameMean : 0.0)
+                  << std::setprecision(3) << std::endl;
+    }
+}
+
+// Guardar las posiciones actuales antes de avanzar un paso, para poder dibujar
+// interpolando entre el paso anterior y el actual
+void savePreviousState(World& world) {
+    world.nebula.previousX = world.nebula.x;
+    world.nebula.previousY = world.nebula.y;
+    for (auto& star : world.stars) {
+        star.previousY = star.y;
+    }
+    world.planetPositions.previousX = world.planetPositions.x;
+    world.planetPositions.previousY = world.planetPositions.y;
+    for (auto& asteroid : world.asteroids) {
+        asteroid.previousX = asteroid.x;
+        asteroid.previousY = asteroid.y;
+    }
+}
+
+// Región única (--region-unica): en vez de abrir y cerrar una región paralela
+// por bucle, los pasos del cuadro y el dibujo corren dentro de una sola región.
+// Los bucles independientes se reparten sin barrera entre ellos (nowait) y solo
+// se espera donde hay una dependencia real. La gravedad usa sus propias regiones,
+// así que con --gravedad la actualización sigue con una región por bucle.
+bool persistentRegion = false;
+
+// En la región única solo el hilo principal mide las etapas
+inline Uint64 recordMasterStage(ProfileStage stage, Uint64 start) {
+    return omp_get_thread_num() == 0 ? recordStage(stage, start) : start;
+}
+
+// Guardar el estado anterior y avanzar un paso en el mismo bucle, elemento por
+// elemento, para los modos en que cada parte del mundo avanza por su cuenta sin
+// esperar a un savePreviousState de todo el mundo (sin gravedad)
+template <typename Policy>
+void advanceNebula(Policy, Nebula& nebula, Uint32 step) {
+    size_t count = nebula.x.size();
+    Policy::forEach((count + nebulaBlockSize - 1) / nebulaBlockSize, 4, [&](size_t block) {
+        size_t begin = block * nebulaBlockSize, end = std::min(count, begin + nebulaBlockSize);
+        std::copy(nebula.x.begin() + begin, nebula.x.begin() + end, nebula.previousX.begin() + begin);
+        std::copy(nebula.y.begin() + begin, nebula.y.begin() + end, nebula.previousY.begin() + begin);
+        updateNebula(nebula, begin, end, step);
+    });
+}
+
+template <typename Policy>
+void advanceStars(Policy, std::vector<Star>& stars, Uint32 step) {
+    Policy::forEach(stars.size(), 1024, [&](size_t i) {
+        stars[i].previousY = stars[i].y;
+        updateStar(stars[i], i, step);
+    });
+}
+
+template <typename Policy>
+void advancePlanets(Policy, std::vector<Planet>& planets, PlanetPositions& positions, Uint32 currentTime) {
+    Policy::forEach(planets.size(), 256, [&](size_t i) {
+        positions.previousX[i] = positions.x[i];
+        positions.previousY[i] = positions.y[i];
+        updatePlanet(planets[i], currentTime);
+        storePlanetPosition(positions, i, planets[i]);
+    });
+}
+
+template <typename Policy>
+void advanceAsteroids(Policy, std::vector<Asteroid>& asteroids) {
+    Policy::forEach(asteroids.size(), 1024, [&](size_t i) {
+        asteroids[i].previousX = asteroids[i].x;
+        asteroids[i].previousY = asteroids[i].y;
+        updateAsteroid(asteroids[i]);
+    });
+}
+
+// Un paso de la simulación dentro de la región única; lo llaman todos los hilos.
+// Los cinco bucles de actualización no dependen entre sí, así que van seguidos
+// con una sola barrera al final. Las colisiones leen planetas y asteroides.
+void updateWorldTeam(World& world, Uint32 currentTime) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    withStagePolicy(LoopNebula, [&](auto policy) {
+        advanceNebula(NowaitPolicy<decltype(policy)>(), world.nebula, world.step);
+    });
+    withStagePolicy(LoopStars, [&](auto policy) {
+        advanceStars(NowaitPolicy<decltype(policy)>(), world.stars, world.step);
+    });
+    withStagePolicy(LoopPlanets, [&](auto policy) {
+        advancePlanets(NowaitPolicy<decltype(policy)>(), world.planets, world.planetPositions, currentTime);
+    });
+    withStagePolicy(LoopExplosions, [&](auto policy) {
+        decltype(policy)::teamForEach(world.explosions.active.size(), 16, [&](size_t i) {
+            updateExplosion(world.explosions.slots[world.explosions.active[i]]);
+        });
+    });
+    withStagePolicy(LoopAsteroids, [&](auto policy) {
+        advanceAsteroids(NowaitPolicy<decltype(policy)>(), world.asteroids);
+    });
+    timedBarrier();
+    start = recordMasterStage(StageUpdateLoops, start);
+
+    // Liberar las explosiones terminadas mientras otro hilo arma la grilla
+    #pragma omp single nowait
+    releaseFinishedExplosions(world.explosions);
+    withStagePolicy(LoopCollisions, [&](auto policy) {
+        detectCollisions(TeamPolicy<decltype(policy)>(), world.planets, world.planetPositions, world.asteroids, collisionAxis);
+    });
+    #pragma omp single
+    {
+        applyCollisions(world.planets, world.planetPositions, world.explosions, currentTime);
+        world.step++;
+    }
+    recordMasterStage(StageCollisions, start);
+}
+
+// El dibujo dentro de la región única; lo llaman todos los hilos. Las cinco
+// etapas paralelas graban sus comandos sin esperarse entre sí, y después el hilo
+// principal limpia, envía cada etapa en orden y dibuja el agujero negro entre
+// medio, igual que renderWorld.
+void renderWorldTeam(Canvas& canvas, const World& world, float alpha) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    drawNebula(canvas, world.nebula, alpha);
+    drawStars(canvas, world.stars, alpha);
+    drawPlanets(canvas, world.planets, world.planetPositions, alpha);
+    drawAllExplosions(canvas, world.explosions);
+    drawAsteroids(canvas, world.asteroids, alpha);
+    timedBarrier();
+    start = recordMasterStage(StageDrawRecord, start);
+
+    #pragma omp master
+    {
+        clearCanvas(canvas, {0, 0, 0, 255});
+        start = recordStage(StageClear, start);
+        submitTeamDraw(canvas, LoopDrawNebula);
+        start = recordStage(StageDrawNebula, start);
+        submitTeamDraw(canvas, LoopDrawStars);
+        start = recordStage(StageDrawStars, start);
+        drawBlackHole(canvas, 320, 240, world.step);
+        start = recordStage(StageDrawBlackHole, start);
+        submitTeamDraw(canvas, LoopDrawPlanets);
+        start = recordStage(StageDrawPlanets, start);
+        submitTeamDraw(canvas, LoopDrawExplosions);
+        start = recordStage(StageDrawExplosions, start);
+        submitTeamDraw(canvas, LoopDrawAsteroids);
+        recordStage(StageDrawAsteroids, start);
+    }
+}
+
+// Fase de actualización: avanza la simulación un paso fijo sin tocar el renderer
+void updateWorld(World& world, Uint32 currentTime) {
+    if (persistentRegion && !gravityEnabled) {
+        parallelRegion([&]() { updateWorldTeam(world, currentTime); });
+        return;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    savePreviousState(world);
+    start = recordStage(StageSaveState, start);
+    if (gravityEnabled) {
+        applyGravity(world);
+        start = recordStage(StageGravity, start);
+    }
+    updateAllNebula(world.nebula, world.step);
+    start = recordStage(StageUpdateNebula, start);
+    updateStars(world.stars, world.step);
+    start = recordStage(StageUpdateStars, start);
+    updatePlanets(world.planets, world.planetPositions, currentTime);
+    start = recordStage(StageUpdatePlanets, start);
+    updateAllExplosions(world.explosions);
+    start = recordStage(StageUpdateExplosions, start);
+    updateAsteroids(world.asteroids);
+    start = recordStage(StageUpdateAsteroids, start);
+
+    // Verificar colisiones y gestionar la desaparición de planetas
+    checkAllCollisions(world.planets, world.planetPositions, world.asteroids, world.explosions, currentTime);
+    recordStage(StageCollisions, start);
+    world.step++;
+}
+
+// Fase de dibujo: compone la escena completa a partir del mundo, sin modificarlo.
+// alpha indica cuánto del paso siguiente ya transcurrió, para interpolar.
+void renderWorld(Canvas& canvas, const World& world, float alpha) {
+    if (persistentRegion) {
+        prepareTeamDrawLists(omp_get_max_threads());
+        recordingInTeam = true;
+        parallelRegion([&]() { renderWorldTeam(canvas, world, alpha); });
+        recordingInTeam = false;
+        return;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    // Limpiar la pantalla
+    clearCanvas(canvas, {0, 0, 0, 255});
+    start = recordStage(StageClear, start);
+
+    // Dibujar Nebulosa
+    drawNebula(canvas, world.nebula, alpha);
+    start = recordStage(StageDrawNebula, start);
+
+    // Dibujar estrellas
+    drawStars(canvas, world.stars, alpha);
+    start = recordStage(StageDrawStars, start);
+
+    // Dibujar agujero negro en el centro de la pantalla
+    drawBlackHole(canvas, 320, 240, world.step);
+    start = recordStage(StageDrawBlackHole, start);
+
+    // Dibujar planetas y explosiones
+    drawPlanets(canvas, world.planets, world.planetPositions, alpha);
+    start = recordStage(StageDrawPlanets, start);
+    drawAllExplosions(canvas, world.explosions);
+    start = recordStage(StageDrawExplosions, start);
+
+    // Dibujar asteroides
+    drawAsteroids(canvas, world.asteroids, alpha);
+    recordStage(StageDrawAsteroids, start);
+}
+
+// Un cuadro completo en la región única: los steps pasos de la simulación desde
+// simulationTime y el dibujo. Devuelve el instante en que terminó la actualización.
+Uint64 runFrameInRegion(World& world, Canvas& canvas, int steps, double& simulationTime, double stepMs, float alpha) {
+    Uint64 updateEnd = 0;
+    prepareTeamDrawLists(omp_get_max_threads());
+    recordingInTeam = true;
+    parallelRegion([&]() {
+        double time = simulationTime;
+        for (int step = 0; step < steps; step++) {
+            updateWorldTeam(world, Uint32(time));
+            time += stepMs;
+        }
+        #pragma omp master
+        updateEnd = SDL_GetPerformanceCounter();
+        renderWorldTeam(canvas, world, alpha);
+    });
+    recordingInTeam = false;
+    for (int step = 0; step < steps; step++) simulationTime += stepMs;
+    return updateEnd;
+}
+
+// Grafo de tareas del cuadro (--grafo-tareas). La nebulosa, las estrellas, las
+// órbitas, las explosiones y los asteroides no comparten datos hasta las
+// colisiones y la composición, así que cada etapa es una tarea de OpenMP con
+// cláusulas depend sobre lo que lee y lo que modifica, y las independientes
+// corren a la vez. Dentro de cada tarea el bucle se parte con taskloop. El hilo
+// principal compone la imagen cuando terminan todas. La gravedad usa sus
+// propias regiones, así que con --gravedad el cuadro no usa el grafo.
+bool useTaskGraph = false;
+
+// Datos sobre los que se declaran las dependencias
+enum GraphResource {
+    ResourceNone, ResourceNebula, ResourceStars, ResourcePlanets, ResourceExplosions, ResourceAsteroids,
+    ResourceNebulaCommands, ResourceStarCommands, ResourcePlanetCommands, ResourceExplosionCommands, ResourceAsteroidCommands,
+    ResourceCount
+};
+Uint8 graphResources[ResourceCount];  // Solo se usan sus direcciones en las cláusulas depend
+
+enum GraphNode {
+    NodeNebula, NodeStars, NodePlanets, NodeExplosions, NodeAsteroids, NodeCollisions,
+    NodeDrawNebula, NodeDrawStars, NodeDrawPlanets, NodeDrawExplosions, NodeDrawAsteroids,
+    NodeCount
+};
+struct GraphNodeInfo {
+    const char* name;
+    ProfileStage stage;         // Etapa del perfilador donde se suma su tiempo
+    GraphResource read;         // Lo que lee sin modificar (ResourceNone si nada)
+    GraphResource writes[2];    // Lo que modifica (la segunda puede repetir la primera)
+};
+const GraphNodeInfo graphNodes[NodeCount] = {
+    { "nebulosa", StageUpdateNebula, ResourceNone, { ResourceNebula, ResourceNebula } },
+    { "estrellas", StageUpdateStars, ResourceNone, { ResourceStars, ResourceStars } },
+    { "planetas", StageUpdatePlanets, ResourceNone, { ResourcePlanets, ResourcePlanets } },
+    { "explosiones", StageUpdateExplosions, ResourceNone, { ResourceExplosions, ResourceExplosions } },
+    { "asteroides", StageUpdateAsteroids, ResourceNone, { ResourceAsteroids, ResourceAsteroids } },
+    { "colisiones", StageCollisions, ResourceAsteroids, { ResourcePlanets, ResourceExplosions } },
+    { "dibujar-nebulosa", StageDrawRecord, ResourceNebula, { ResourceNebulaCommands, ResourceNebulaCommands } },
+    { "dibujar-estrellas", StageDrawRecord, ResourceStars, { ResourceStarCommands, ResourceStarCommands } },
+    { "dibujar-planetas", StageDrawRecord, ResourcePlanets, { ResourcePlanetCommands, ResourcePlanetCommands } },
+    { "dibujar-explosiones", StageDrawRecord, ResourceExplosions, { ResourceExplosionCommands, ResourceExplosionCommands } },
+    { "dibujar-asteroides", StageDrawRecord, ResourceAsteroids, { ResourceAsteroidCommands, ResourceAsteroidCommands } },
+};
+
+// Una tarea del cuadro: una etapa en un paso de la simulación. inputs son las
+// tareas anteriores de las que depende, con la misma regla que las cláusulas
+// depend (leer espera al último que escribió; escribir espera además a los que
+// leyeron desde entonces). Sirven para calcular el camino crítico.
+struct GraphTask {
+    GraphNode node;
+    int step;                  // Paso dentro del cuadro (el dibujo usa el último)
+    std::vector<int> inputs;
+    Uint64 start, end;
+};
+
+std::vector<GraphTask> frameGraph;
+
+// Armar las tareas de un cuadro con steps pasos y el dibujo, en un orden en que
+// cada tarea aparece después de sus entradas
+void buildFrameGraph(int steps) {
+    frameGraph.clear();
+    int lastWriter[ResourceCount];
+    std::vector<int> readers[ResourceCount];
+    std::fill(lastWriter, lastWriter + ResourceCount, -1);
+    auto addTask = [&](GraphNode node, int step) {
+        const GraphNodeInfo& info = graphNodes[node];
+        GraphTask task = { node, step, {}, 0, 0 };
+        if (info.read != ResourceNone && lastWriter[info.read] >= 0) task.inputs.push_back(lastWriter[info.read]);
+        for (GraphResource resource : info.writes) {
+            if (lastWriter[resource] >= 0) task.inputs.push_back(lastWriter[resource]);
+            task.inputs.insert(task.inputs.end(), readers[resource].begin(), readers[resource].end());
+        }
+        int index = int(frameGraph.size());
+        if (info.read != ResourceNone) readers[info.read].push_back(index);
+        for (GraphResource resource : info.writes) {
+            lastWriter[resource] = index;
+            readers[resource].clear();
+        }
+        frameGraph.push_back(task);
+    };
+    for (int step = 0; step < steps; step++) {
+        for (int node = NodeNebula; node <= NodeCollisions; node++) addTask(GraphNode(node), step);
+    }
+    for (int node = NodeDrawNebula; node < NodeCount; node++) addTask(GraphNode(node), steps - 1);
+}
+
+// Ejecutar una tarea del grafo (la llama el hilo que la tomó)
+void runGraphTask(GraphTask& task, World& world, Canvas& canvas, double startTime, double stepMs, float alpha) {
+    task.start = SDL_GetPerformanceCounter();
+    Uint32 step = world.step + task.step;
+    Uint32 currentTime = Uint32(startTime + task.step * stepMs);
+    switch (task.node) {
+        case NodeNebula: advanceNebula(GraphPolicy(), world.nebula, step); break;
+        case NodeStars: advanceStars(GraphPolicy(), world.stars, step); break;
+        case NodePlanets: advancePlanets(GraphPolicy(), world.planets, world.planetPositions, currentTime); break;
+        case NodeExplosions: updateAllExplosions(GraphPolicy(), world.explosions); break;
+        case NodeAsteroids: advanceAsteroids(GraphPolicy(), world.asteroids); break;
+        case NodeCollisions:
+            checkAllCollisions(GraphPolicy(), world.planets, world.planetPositions, world.asteroids, world.explosions, currentTime);
+            break;
+        case NodeDrawNebula: drawNebula(canvas, world.nebula, alpha); break;
+        case NodeDrawStars: drawStars(canvas, world.stars, alpha); break;
+        case NodeDrawPlanets: drawPlanets(canvas, world.planets, world.planetPositions, alpha); break;
+        case NodeDrawExplosions: drawAllExplosions(canvas, world.explosions); break;
+        case NodeDrawAsteroids: drawAsteroids(canvas, world.asteroids, alpha); break;
+        case NodeCount: break;
+    }
+    task.end = SDL_GetPerformanceCounter();
+}
+
+// Crear las tareas del grafo (en el hilo principal, dentro de la región) y
+// esperar a que terminen. world y canvas van como shared: una referencia sin
+// esa cláusula sería firstprivate y la tarea trabajaría sobre una copia.
+void spawnFrameGraph(World& world, Canvas& canvas, double startTime, double stepMs, float alpha) {
+    for (size_t i = 0; i < frameGraph.size(); i++) {
+        const GraphNodeInfo& info = graphNodes[frameGraph[i].node];
+        #pragma omp task shared(world, canvas) depend(in: graphResources[info.read]) depend(inout: graphResources[info.writes[0]], graphResources[info.writes[1]])
+        runGraphTask(frameGraph[i], world, canvas, startTime, stepMs, alpha);
+    }
+    #pragma omp taskwait
+}
+
+// Camino crítico de un cuadro: la cadena de tareas dependientes más larga,
+// terminada en la composición
+struct CriticalPath {
+    Uint64 ticks;          // Duración de la cadena
+    Uint64 workTicks;      // Suma de todas las tareas (lo que tardaría un solo hilo)
+    std::string stages;    // Etapas de la cadena, en orden
+};
+
+CriticalPath findCriticalPath(Uint64 composeTicks) {
+    std::vector<Uint64> longest(frameGraph.size());
+    std::vector<int> previous(frameGraph.size(), -1);
+    CriticalPath path = { 0, composeTicks, "" };
+    int last = -1;
+    for (size_t i = 0; i < frameGraph.size(); i++) {
+        const GraphTask& task = frameGraph[i];
+        for (int input : task.inputs) {
+            if (longest[input] > longest[i]) {
+                longest[i] = longest[input];
+                previous[i] = input;
+            }
+        }
+        longest[i] += task.end - task.start;
+        path.workTicks += task.end - task.start;
+        if (task.node >= NodeDrawNebula && (last < 0 || longest[i] > longest[last])) last = int(i);
+    }
+    path.ticks = (last >= 0 ? longest[last] : 0) + composeTicks;
+    std::vector<int> chain;
+    for (int i = last; i >= 0; i = previous[i]) chain.push_back(i);
+    for (auto i = chain.rbegin(); i != chain.rend(); ++i) path.stages += std::string(graphNodes[frameGraph[*i].node].name) + " > ";
+    path.stages += "componer";
+    return path;
+}
+
+// Totales del grafo desde el inicio, para el resumen del modo headless
+struct GraphStats {
+    Uint64 frames;
+    Uint64 criticalTicks, workTicks, wallTicks;
+    std::unordered_map<std::string, int> paths;  // Veces que cada cadena fue la crítica
+};
+GraphStats graphStats;
+
+// Un cuadro completo con el grafo de tareas: los steps pasos desde simulationTime
+// y el dibujo. Devuelve el instante en que terminó la última tarea de la
+// actualización.
+Uint64 runFrameGraph(World& world, Canvas& canvas, int steps, double& simulationTime, double stepMs, float alpha) {
+    buildFrameGraph(steps);
+    prepareTeamDrawLists(omp_get_max_threads());
+    double startTime = simulationTime;
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 composeTicks = 0;
+    recordingInGraph = true;
+    parallelRegion([&]() {
+        #pragma omp master
+        {
+            spawnFrameGraph(world, canvas, startTime, stepMs, alpha);
+
+            // Componer en el hilo principal, igual que renderWorld
+            Uint64 composeStart = SDL_GetPerformanceCounter();
+            Uint64 stageStart = composeStart;
+            clearCanvas(canvas, {0, 0, 0, 255});
+            stageStart = recordStage(StageClear, stageStart);
+            submitTeamDraw(canvas, LoopDrawNebula);
+            stageStart = recordStage(StageDrawNebula, stageStart);
+            submitTeamDraw(canvas, LoopDrawStars);
+            stageStart = recordStage(StageDrawStars, stageStart);
+            drawBlackHole(canvas, 320, 240, world.step + steps);  // El paso que queda al terminar el grafo
+            stageStart = recordStage(StageDrawBlackHole, stageStart);
+            submitTeamDraw(canvas, LoopDrawPlanets);
+            stageStart = recordStage(StageDrawPlanets, stageStart);
+            submitTeamDraw(canvas, LoopDrawExplosions);
+            stageStart = recordStage(StageDrawExplosions, stageStart);
+            submitTeamDraw(canvas, LoopDrawAsteroids);
+            composeTicks = recordStage(StageDrawAsteroids, stageStart) - composeStart;
+        }
+    });
+    recordingInGraph = false;
+    Uint64 wallTicks = SDL_GetPerformanceCounter() - start;
+
+    Uint64 updateEnd = start;
+    for (const GraphTask& task : frameGraph) {
+        frameProfiler.stages[graphNodes[task.node].stage].pendingTicks += task.end - task.start;
+        if (task.node <= NodeCollisions) updateEnd = std::max(updateEnd, task.end);
+    }
+    CriticalPath path = findCriticalPath(composeTicks);
+    frameProfiler.stages[StageCriticalPath].pendingTicks += path.ticks;
+    graphStats.frames++;
+    graphStats.criticalTicks += path.ticks;
+    graphStats.workTicks += path.workTicks;
+    graphStats.wallTicks += wallTicks;
+    graphStats.paths[path.stages]++;
+
+    world.step += steps;
+    for (int step = 0; step < steps; step++) simulationTime += stepMs;
+    return updateEnd;
+}
+
+// Crear la escena inicial: nebulosa, planetas en órbitas, asteroides y estrellas
+void createWorld(World& world, Canvas& canvas, int numNebulaPoints, int numStars, int numPlanets, int numAsteroids, int explosionCapacity) {
+    initNebula(world.nebula, numNebulaPoints);
+    Random random = streamRandom(StreamScene, 0);
+
+    // Crear planetas en órbitas
+    for (int i = 0; i < numPlanets; i++) {
+        Planet planet;
+        planet.centerX = 320;
+        planet.centerY = 240;
+        planet.orbitRadius = 50 + i * 50;
+        planet.angle = random.below(360);
+        planet.speed = 0.01f + random.below(10) * 0.001f;
+        planet.size = 10 + random.below(10);
+        planet.color = { (Uint8)random.below(256), (Uint8)random.below(256), (Uint8)random.below(256) };
+        planet.isVisible = true;
+        planet.respawnTime = 0;
+        planet.spriteIndex = getPlanetSprite(canvas, planet.size, planet.color);
+        world.planets.push_back(planet);
+    }
+    initPlanetOrbits(world.planets, world.planetPositions);
+
+    // Crear asteroides
+    for (int i = 0; i < numAsteroids; i++) {
+        Asteroid asteroid;
+        asteroid.x = random.below(640);
+        asteroid.y = random.below(480);
+        asteroid.size = 5 + random.below(10);
+        asteroid.dx = 1 + random.below(3);
+        asteroid.dy = 1 + random.below(3);
+        asteroid.color = { 128, 128, 128 };
+        asteroid.exactX = asteroid.x;
+        asteroid.exactY = asteroid.y;
+        asteroid.velocityX = asteroid.dx;
+        asteroid.velocityY = asteroid.dy;
+        world.asteroids.push_back(asteroid);
+    }
+
+    // Crear estrellas
+    for (int i = 0; i < numStars; i++) {
+        Star star;
+        star.x = random.below(640);
+        star.y = random.below(480);
+        star.size = 1 + random.below(2);
+        star.speed = 0.1f + random.below(10) * 0.01f; // Velocidad reducida
+        world.stars.push_back(star);
+    }
+
+    initExplosionPool(world.explosions, explosionCapacity);
+    savePreviousState(world);
+}
+
+// Simulación en un hilo aparte, con el mundo en doble búfer: mientras el hilo
+// principal dibuja y presenta el cuadro N, el trabajador calcula los pasos del
+// cuadro N + 1 sobre su propia copia. Al terminar, el trabajador publica el
+// resultado en el búfer trasero (la copia la hace él, fuera del camino del
+// dibujo). Al empezar cada cuadro el hilo principal espera al trabajador,
+// intercambia el búfer trasero con el mundo que dibuja y le encarga los pasos
+// siguientes. Los hilos de OpenMP se reparten entre ambos.
+struct SimulationPipeline {
+    World world;                  // Mundo que avanza el trabajador
+    World back;                   // Último resultado publicado, para intercambiar
+    bool published;               // back tiene un resultado que el hilo principal no tomó
+    double simulationTime;        // Tiempo simulado del mundo del trabajador (ms)
+    double stepMs;                // Duración de un paso de simulación
+    int threads;                  // Hilos de OpenMP del trabajador
+    int savedThreads;             // Hilos del hilo principal antes de arrancar
+    int pendingSteps;             // Pasos encargados (0 = trabajador libre)
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread worker;
+};
+
+// Copiar en to el estado que cambia entre pasos. to debe venir del mismo mundo
+// inicial que from: la cantidad de elementos y el tamaño de los puntos de la
+// nebulosa no cambian, así que no se copian y no se reserva memoria. La
+// nebulosa, que es la mayor parte, se copia por bloques en paralelo.
+void copyMutableState(World& to, const World& from) {
+    const Nebula& source = from.nebula;
+    Nebula& target = to.nebula;
+    size_t count = source.x.size();
+    int blocks = int((count + nebulaBlockSize - 1) / nebulaBlockSize);
+    #pragma omp parallel for schedule(static)
+    for (int block = 0; block < blocks; block++) {
+        size_t begin = block * nebulaBlockSize, end = std::min(count, begin + nebulaBlockSize);
+        auto copyRange = [&](const auto& values, auto& into) {
+            std::copy(values.begin() + begin, values.begin() + end, into.begin() + begin);
+        };
+        copyRange(source.x, target.x);
+        copyRange(source.y, target.y);
+        copyRange(source.previousX, target.previousX);
+        copyRange(source.previousY, target.previousY);
+        copyRange(source.dx, target.dx);
+        copyRange(source.dy, target.dy);
+        copyRange(source.color, target.color);
+        copyRange(source.colorTransition, target.colorTransition);
+        copyRange(source.colorStage, target.colorStage);
+    }
+    to.stars = from.stars;
+    to.planets = from.planets;
+    to.planetPositions = from.planetPositions;
+    to.asteroids = from.asteroids;
+    to.explosions = from.explosions;
+    to.step = from.step;
+}
+
+// Bucle del hilo trabajador: ejecutar los pasos encargados y avisar al terminar
+void runSimulationWorker(SimulationPipeline& pipeline) {
+    omp_set_num_threads(pipeline.threads);
+    std::unique_lock<std::mutex> lock(pipeline.mutex);
+    while (true) {
+        pipeline.changed.wait(lock, [&] { return pipeline.stopping || pipeline.pendingSteps > 0; });
+        if (pipeline.stopping) return;
+
+        int steps = pipeline.pendingSteps;
+        lock.unlock();
+        for (int step = 0; step < steps; step++) {
+            updateWorld(pipeline.world, Uint32(pipeline.simulationTime));
+            pipeline.simulationTime += pipeline.stepMs;
+        }
+        // Mientras haya pasos pendientes el hilo principal no toca back
+        Uint64 start = SDL_GetPerformanceCounter();
+        copyMutableState(pipeline.back, pipeline.world);
+        recordStage(StagePipelinePublish, start);
+        lock.lock();
+        pipeline.published = true;
+        pipeline.pendingSteps = 0;
+        pipeline.changed.notify_all();
+    }
+}
+
+// Arrancar el trabajador a partir de una copia del mundo. Se queda con la mitad
+// de los hilos de OpenMP (al menos uno) y el hilo principal con el resto.
+void startPipeline(SimulationPipeline& pipeline, const World& world, double simulationTime, double stepMs) {
+    int maxThreads = omp_get_max_threads();
+    pipeline.world = world;
+    pipeline.back = world;  // Después solo se copia lo que cambia (copyMutableState)
+    pipeline.simulationTime = simulationTime;
+    pipeline.stepMs = stepMs;
+    pipeline.threads = std::max(1, maxThreads / 2);
+    pipeline.savedThreads = maxThreads;
+    pipeline.published = false;
+    pipeline.pendingSteps = 0;
+    pipeline.stopping = false;
+    omp_set_num_threads(std::max(1, maxThreads - pipeline.threads));
+    pipeline.worker = std::thread(runSimulationWorker, std::ref(pipeline));
+}
+
+// Esperar a que el trabajador termine los pasos encargados y tomar su resultado
+// intercambiando los búferes (sin copiar el mundo en el hilo principal)
+void collectSteps(SimulationPipeline& pipeline, World& world) {
+    std::unique_lock<std::mutex> lock(pipeline.mutex);
+    pipeline.changed.wait(lock, [&] { return pipeline.pendingSteps == 0; });
+    if (!pipeline.published) return;
+    std::swap(world, pipeline.back);
+    pipeline.published = false;
+}
+
+// Encargar al trabajador los pasos del siguiente cuadro (no bloquea)
+void launchSteps(SimulationPipeline& pipeline, int steps) {
+    if (steps <= 0) return;
+    std::lock_guard<std::mutex> lock(pipeline.mutex);
+    pipeline.pendingSteps = steps;
+    pipeline.changed.notify_all();
+}
+
+// Detener el trabajador y devolver los hilos de OpenMP al hilo principal
+void stopPipeline(SimulationPipeline& pipeline) {
+    {
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        pipeline.stopping = true;
+        pipeline.changed.notify_all();
+    }
+    pipeline.worker.join();
+    omp_set_num_threads(pipeline.savedThreads);
+}
+
+// Benchmark de círculos: dibuja la carga típica de un cuadro (estrellas,
+// gradientes de planetas y capas de explosión) con drawCirclePerPixel y con
+// drawCircle sobre un renderer por software, y compara llamadas y tiempo.
+int runCircleBenchmark() {
+    const int width = 640, height = 480;
+    const int numFrames = 100;
+
+    // Carga de trabajo fija para que las corridas sean comparables
+    struct CircleJob { int x, y, radius; SDL_Color color; };
+    std::vector<CircleJob> jobs;
+    Random random = { 12345 };
+    for (int i = 0; i < 1000; i++) {  // Estrellas
+        jobs.push_back({ random.below(width), random.below(height), 1 + random.below(2), {255, 255, 255} });
+    }
+    for (int i = 0; i < 10; i++) {  // Planetas con gradiente
+        int x = random.below(width), y = random.below(height), size = 10 + random.below(10);
+        for (int j = 0; j < size; j++) {
+            jobs.push_back({ x, y, size - j, { Uint8(255 * (size - j) / size), 0, 0 } });
+        }
+    }
+    for (int i = 0; i < 5; i++) {  // Explosiones de tres capas
+        int x = random.below(width), y = random.below(height);
+        jobs.push_back({ x, y, 30, {255, 69, 0, 255} });
+        jobs.push_back({ x, y, 26, {255, 255, 0, 255} });
+        jobs.push_back({ x, y, 20, {255, 255, 255, 255} });
+    }
+
+    // Llamadas de dibujo por cuadro: un punto por píxel contra un lote por círculo
+    Uint64 perPixelCalls = 0, spanCalls = 0;
+    std::vector<SDL_Rect> spans;
+    for (const CircleJob& job : jobs) {
+        spans.resize(std::max(job.radius * 2, 1));
+        int count = buildCircleSpans(job.x, job.y, job.radius, spans.data());
+        for (int i = 0; i < count; i++) perPixelCalls += spans[i].w;
+        spanCalls += 1;
+    }
+
+    SDL_Surface* surfaces[2];
+    double frameMs[2];
+    for (int variant = 0; variant < 2; variant++) {
+        surfaces[variant] = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(surfaces[variant]);
+        if (surfaces[variant] == nullptr || renderer == nullptr) {
+            std::cerr << "Error: No se pudo crear el renderer por software: " << SDL_GetError() << std::endl;
+            return 1;
+        }
+
+        Canvas canvas = { renderer, nullptr, width, height };
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int frame = 0; frame < numFrames; frame++) {
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+            for (const CircleJob& job : jobs) {
+                if (variant == 0) {
+                    drawCirclePerPixel(renderer, job.x, job.y, job.radius, job.color);
+                } else {
+                    drawCircle(canvas, job.x, job.y, job.radius, job.color);
+                }
+            }
+        }
+        Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+        frameMs[variant] = elapsed * 1000.0 / SDL_GetPerformanceFrequency() / numFrames;
+        SDL_DestroyRenderer(renderer);
+    }
+
+    // Ambas versiones deben producir exactamente los mismos píxeles
+    bool identical = true;
+    for (int y = 0; y < height && identical; y++) {
+        const Uint8* rowA = (const Uint8*)surfaces[0]->pixels + y * surfaces[0]->pitch;
+        const Uint8* rowB = (const Uint8*)surfaces[1]->pixels + y * surfaces[1]->pitch;
+        identical = std::equal(rowA, rowA + width * 4, rowB);
+    }
+    SDL_FreeSurface(surfaces[0]);
+    SDL_FreeSurface(surfaces[1]);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Círculos por cuadro: " << jobs.size() << std::endl;
+    std::cout << "Por píxel: " << perPixelCalls << " llamadas/cuadro, " << frameMs[0] << " ms/cuadro" << std::endl;
+    std::cout << "Por tramos: " << spanCalls << " llamadas/cuadro, " << frameMs[1] << " ms/cuadro" << std::endl;
+    std::cout << "Aceleración: " << frameMs[0] / frameMs[1] << "x" << std::endl;
+    std::cout << "Píxeles idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Benchmark de planetas: dibuja 1000 planetas por cuadro con el gradiente
+// círculo por círculo y con el sprite pre-rasterizado, en ambos backends.
+int runPlanetBenchmark() {
+    const int width = 640, height = 480;
+    const int numPlanets = 1000;
+    const int numFrames = 20;
+
+    struct PlanetJob { int x, y, size; SDL_Color color; };
+    std::vector<PlanetJob> jobs;
+    Random random = { 12345 };
+    for (int i = 0; i < numPlanets; i++) {
+        jobs.push_back({ random.below(width), random.below(height), 10 + random.below(10),
+                         { Uint8(random.below(256)), Uint8(random.below(256)), Uint8(random.below(256)), 255 } });
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (renderer == nullptr) {
+        std::cerr << "Error: No se pudo crear el renderer por software: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    std::vector<Uint32> framebuffers[2] = { std::vector<Uint32>(width * height), std::vector<Uint32>(width * height) };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Planetas por cuadro: " << numPlanets << std::endl;
+    for (int backend = 0; backend < 2; backend++) {
+        for (int cached = 0; cached < 2; cached++) {
+            Canvas canvas = { renderer, nullptr, width, height };
+            if (backend == 1) canvas = { nullptr, framebuffers[cached].data(), width, height };
+
+            // La creación de los sprites queda fuera de la medición, igual que en main
+            std::vector<int> sprites;
+            if (cached) {
+                for (const PlanetJob& job : jobs) sprites.push_back(getPlanetSprite(canvas, job.size, job.color));
+            }
+
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (int frame = 0; frame < numFrames; frame++) {
+                clearCanvas(canvas, {0, 0, 0, 255});
+                for (size_t i = 0; i < jobs.size(); i++) {
+                    if (cached) {
+                        drawSprite(canvas, planetSprites[sprites[i]], jobs[i].x, jobs[i].y);
+                    } else {
+                        drawPlanetGradient(canvas, jobs[i].x, jobs[i].y, jobs[i].size, jobs[i].color);
+                    }
+                }
+            }
+            double seconds = double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+            releasePlanetSprites();
+
+            std::cout << (backend == 0 ? "SDL" : "Framebuffer") << (cached ? ", sprite: " : ", gradiente: ")
+                      << numPlanets * numFrames / seconds << " planetas/s, "
+                      << seconds * 1000.0 / numFrames << " ms/cuadro" << std::endl;
+        }
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+
+    // En el framebuffer el sprite debe reproducir exactamente el gradiente
+    bool identical = framebuffers[0] == framebuffers[1];
+    std::cout << "Píxeles idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Benchmark del agujero negro: mide cada etapa de drawBlackHole por separado
+// (núcleo, aros y disco de acreción) y compara el núcleo redibujado radio por
+// radio con la capa estática, en ambos backends.
+int runBlackHoleBenchmark() {
+    const int width = 640, height = 480;
+    const int numFrames = 50;
+    const char* stageNames[] = { "Núcleo por radio", "Núcleo en capa", "Aros", "Disco" };
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (renderer == nullptr) {
+        std::cerr << "Error: No se pudo crear el renderer por software: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    std::vector<Uint32> framebuffer(width * height);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Milisegundos por cuadro de cada etapa (" << numFrames << " cuadros)" << std::endl;
+    for (int backend = 0; backend < 2; backend++) {
+        Canvas canvas = { renderer, nullptr, width, height };
+        if (backend == 1) canvas = { nullptr, framebuffer.data(), width, height };
+        initBlackHole(canvas);
+
+        std::cout << (backend == 0 ? "SDL:" : "Framebuffer:") << std::endl;
+        for (int stage = 0; stage < 4; stage++) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (int frame = 0; frame < numFrames; frame++) {
+                if (stage == 0) drawBlackHoleCorePerRadius(canvas, 320, 240);
+                if (stage == 1) drawSprite(canvas, blackHoleCore, 320, 240);
+                if (stage == 2) drawAccretionRings(canvas, 320, 240, frame);
+                if (stage == 3) drawAccretionDisk(canvas, frame);
+            }
+            double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / numFrames;
+            std::cout << "  " << stageNames[stage] << ": " << ms << " ms" << std::endl;
+        }
+        releaseBlackHole();
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+
+    // La capa estática debe cubrir exactamente los mismos píxeles que el núcleo original
+    Canvas canvas = { nullptr, framebuffer.data(), width, height };
+    initBlackHole(canvas);
+    clearCanvas(canvas, {32, 32, 32, 255});
+    drawBlackHoleCorePerRadius(canvas, 320, 240);
+    std::vector<Uint32> reference = framebuffer;
+    clearCanvas(canvas, {32, 32, 32, 255});
+    drawSprite(canvas, blackHoleCore, 320, 240);
+    releaseBlackHole();
+
+    bool identical = framebuffer == reference;
+    std::cout << "Píxeles idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Microbenchmark de la nebulosa: puntos actualizados por segundo con el kernel
+// escalar y con el kernel AVX2 sobre la misma nebulosa (sin dibujar)
+int runNebulaBenchmark() {
+    const int numPoints = 500000;
+    const int numSteps = 100;
+
+    struct Kernel { const char* name; void (*update)(Nebula&, size_t, size_t, Uint32); };
+    std::vector<Kernel> kernels = { { "Escalar", updateNebulaScalar } };
+#if defined(__x86_64__) || defined(__i386__)
+    if (cpuHasAVX2()) kernels.push_back({ "AVX2", updateNebulaAVX2 });
+#endif
+    if (kernels.size() == 1) std::cout << "AVX2 no está disponible en esta CPU" << std::endl;
+
+    randomSeed = 12345;
+    Nebula initial;
+    initNebula(initial, numPoints);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Puntos de nebulosa: " << numPoints << ", pasos: " << numSteps << std::endl;
+    std::vector<double> pointsPerSecond;
+    std::vector<Nebula> results;
+    for (const Kernel& kernel : kernels) {
+        Nebula nebula = initial;
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int step = 0; step < numSteps; step++) {
+            kernel.update(nebula, 0, numPoints, step);
+        }
+        double seconds = double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        pointsPerSecond.push_back(double(numPoints) * numSteps / seconds);
+        results.push_back(nebula);
+        std::cout << kernel.name << ": " << pointsPerSecond.back() / 1e6 << " millones de puntos/s" << std::endl;
+    }
+    if (kernels.size() < 2) return 0;
+    std::cout << "Aceleración: " << pointsPerSecond[1] / pointsPerSecond[0] << "x" << std::endl;
+
+    // Con la misma semilla ambos kernels deben llegar al mismo estado
+    bool identical = results[0].x == results[1].x && results[0].y == results[1].y &&
+                     results[0].colorStage == results[1].colorStage &&
+                     std::equal(results[0].color.begin(), results[0].color.end(), results[1].color.begin(),
+                                [](SDL_Color a, SDL_Color b) { return packColor(a) == packColor(b); });
+    std::cout << "Resultados idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Mismas explosiones, en el mismo orden y posición
+bool sameExplosions(const ExplosionPool& a, const ExplosionPool& b) {
+    if (a.active.size() != b.active.size()) return false;
+    for (size_t i = 0; i < a.active.size(); i++) {
+        const Explosion& first = a.slots[a.active[i]];
+        const Explosion& second = b.slots[b.active[i]];
+        if (first.x != second.x || first.y != second.y || first.radiusOrange != second.radiusOrange) return false;
+    }
+    return true;
+}
+
+// Cantidades de hilos que recorren los benchmarks: 1, 2, 4... y el máximo disponible
+std::vector<int> benchmarkThreadCounts() {
+    int maxThreads = omp_get_max_threads();
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) threadCounts.push_back(threads);
+    if (threadCounts.back() != maxThreads) threadCounts.push_back(maxThreads);
+    return threadCounts;
+}
+
+// Benchmark de colisiones: la grilla uniforme contra el recorrido de todos los
+// planetas contra todos los asteroides, sobre la misma escena fija. Los asteroides
+// se mueven entre cuadros y solo se mide la detección de colisiones.
+int runCollisionBenchmark() {
+    const int width = 640, height = 480;
+    const int numPlanets = 10000;
+    const int numAsteroids = 100000;
+    const int numFrames = 5;
+
+    Random random = { 12345 };
+    std::vector<Planet> initialPlanets(numPlanets);
+    for (Planet& planet : initialPlanets) {
+        planet = { 320, 240, float(50 + random.below(200)), float(random.below(360)), 0.01f + random.below(10) * 0.001f,
+                   10 + random.below(10), { 255, 255, 255, 255 }, true, 0, 0 };
+    }
+    PlanetPositions positions;
+    initPlanetOrbits(initialPlanets, positions);
+    std::vector<Asteroid> initialAsteroids(numAsteroids);
+    for (Asteroid& asteroid : initialAsteroids) {
+        asteroid = { random.below(width), random.below(height), 5 + random.below(10), 1 + random.below(3), 1 + random.below(3), {128, 128, 128, 255} };
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Planetas: " << numPlanets << ", asteroides: " << numAsteroids << ", cuadros: " << numFrames << std::endl;
+    // Correr los cuadros desde la escena inicial y devolver los ms por cuadro
+    auto run = [&](bool bruteForce, std::vector<Planet>& planets, ExplosionPool& explosions) {
+        planets = initialPlanets;
+        initExplosionPool(explosions, numPlanets);
+        std::vector<Asteroid> asteroids = initialAsteroids;
+        Uint64 ticks = 0;
+        for (int frame = 0; frame < numFrames; frame++) {
+            for (Asteroid& asteroid : asteroids) updateAsteroid(asteroid);
+            Uint64 start = SDL_GetPerformanceCounter();
+            if (bruteForce) {
+                checkAllCollisionsBruteForce(planets, positions, asteroids, explosions, 0);
+            } else {
+                checkAllCollisions(planets, positions, asteroids, explosions, 0);
+            }
+            ticks += SDL_GetPerformanceCounter() - start;
+        }
+        return 1000.0 * ticks / SDL_GetPerformanceFrequency() / numFrames;
+    };
+
+    // Todos los métodos deben detectar exactamente las mismas colisiones
+    std::vector<Planet> referencePlanets, planets;
+    ExplosionPool referenceExplosions, explosions;
+    auto matchesReference = [&]() {
+        for (int i = 0; i < numPlanets; i++) {
+            if (referencePlanets[i].isVisible != planets[i].isVisible) return false;
+        }
+        return sameExplosions(referenceExplosions, explosions);
+    };
+
+    double bruteForceMs = run(true, referencePlanets, referenceExplosions);
+    std::cout << "Todos contra todos: " << bruteForceMs << " ms/cuadro" << std::endl;
+
+    // Grilla con eventos, repartida por cada eje y con 1, 2, 4... hilos
+    std::vector<int> threadCounts = benchmarkThreadCounts();
+    int maxThreads = omp_get_max_threads();
+    CollisionAxis savedAxis = collisionAxis;
+    bool identical = true;
+    for (int axis = 0; axis < AxisCount; axis++) {
+        collisionAxis = CollisionAxis(axis);
+        for (int threads : threadCounts) {
+            omp_set_num_threads(threads);
+            double ms = run(false, planets, explosions);
+            bool same = matchesReference();
+            identical = identical && same;
+            std::cout << "Grilla por " << collisionAxisNames[axis] << ", " << threads << " hilo(s): " << ms
+                      << " ms/cuadro, aceleración " << bruteForceMs / ms << "x" << (same ? "" : " (distinto)") << std::endl;
+        }
+    }
+    collisionAxis = savedAxis;
+    omp_set_num_threads(maxThreads);
+
+    int collisions = 0;
+    for (const Planet& planet : referencePlanets) {
+        if (!planet.isVisible) collisions++;
+    }
+    std::cout << "Planetas alcanzados: " << collisions << std::endl;
+    std::cout << "Resultados idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Benchmark de órbitas: avanzar los planetas recalculando cos/sin del ángulo en
+// cada paso (como antes) contra la rotación incremental de updatePlanet
+int runOrbitBenchmark() {
+    const int numPlanets = 100000;
+    const int numSteps = 600;
+
+    Random random = { 12345 };
+    std::vector<Planet> planets(numPlanets);
+    for (Planet& planet : planets) {
+        planet = { 320, 240, float(50 + random.below(200)), float(random.below(360)), 0.01f + random.below(10) * 0.001f,
+                   10 + random.below(10), { 255, 255, 255, 255 }, true, 0, 0 };
+    }
+    PlanetPositions rotated;
+    initPlanetOrbits(planets, rotated);
+    PlanetPositions trig = rotated;
+    std::vector<float> angles(numPlanets);
+    for (int i = 0; i < numPlanets; i++) angles[i] = planets[i].angle;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Planetas: " << numPlanets << ", pasos: " << numSteps << std::endl;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int step = 0; step < numSteps; step++) {
+        #pragma omp parallel for
+        for (int i = 0; i < numPlanets; i++) {
+            const Planet& planet = planets[i];
+            angles[i] += planet.speed;
+            trig.x[i] = planet.centerX + planet.orbitRadius * cos(angles[i]);
+            trig.y[i] = planet.centerY + planet.orbitRadius * sin(angles[i]);
+        }
+    }
+    double trigMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / numSteps;
+
+    start = SDL_GetPerformanceCounter();
+    for (int step = 0; step < numSteps; step++) {
+        updatePlanets(planets, rotated, 0);
+    }
+    double rotationMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / numSteps;
+
+    // Diferencia de posición entre ambos métodos al terminar (por redondeo)
+    float maxError = 0;
+    for (int i = 0; i < numPlanets; i++) {
+        maxError = std::max(maxError, std::max(std::abs(trig.x[i] - rotated.x[i]), std::abs(trig.y[i] - rotated.y[i])));
+    }
+    std::cout << "cos/sin por paso: " << trigMs << " ms/paso" << std::endl;
+    std::cout << "Rotación incremental: " << rotationMs << " ms/paso" << std::endl;
+    std::cout << "Aceleración: " << trigMs / rotationMs << "x" << std::endl;
+    std::cout << "Diferencia máxima: " << maxError << " píxeles" << std::endl;
+    return 0;
+}
+
+// Benchmark de dibujo paralelo: dibuja estrellas, planetas, explosiones y
+// asteroides en el framebuffer con los bucles secuenciales y con parallelDraw
+// para 1, 2, 4... hilos, y reporta la aceleración respecto al secuencial.
+int runParallelDrawBenchmark() {
+    const int width = 640, height = 480;
+    const int numFrames = 50;
+
+    std::vector<Uint32> framebuffer(width * height);
+    Canvas canvas = { nullptr, framebuffer.data(), width, height };
+
+    // Escena fija para que todas las corridas dibujen lo mismo
+    std::vector<Star> initialStars(20000);
+    std::vector<Planet> initialPlanets(2000);
+    std::vector<Asteroid> initialAsteroids(20000);
+    ExplosionPool initialExplosions;
+    initExplosionPool(initialExplosions, 500);
+    Random random = { 12345 };
+    for (Star& star : initialStars) {
+        star = { random.below(width), random.below(height), 1 + random.below(2), 0.1f + random.below(10) * 0.01f };
+    }
+    for (Planet& planet : initialPlanets) {
+        planet = { 320, 240, float(50 + random.below(200)), float(random.below(360)), 0.01f + random.below(10) * 0.001f,
+                   10 + random.below(10), { Uint8(random.below(256)), Uint8(random.below(256)), Uint8(random.below(256)), 255 }, true, 0, 0 };
+        planet.spriteIndex = getPlanetSprite(canvas, planet.size, planet.color);
+    }
+    PlanetPositions initialPositions;
+    initPlanetOrbits(initialPlanets, initialPositions);
+    for (Asteroid& asteroid : initialAsteroids) {
+        asteroid = { random.below(width), random.below(height), 5 + random.below(10), 1 + random.below(3), 1 + random.below(3), {128, 128, 128, 255} };
+    }
+    for (int i = 0; i < 500; i++) {
+        spawnExplosion(initialExplosions, random.below(width), random.below(height));
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Estrellas: " << initialStars.size() << ", planetas: " << initialPlanets.size()
+              << ", asteroides: " << initialAsteroids.size() << ", explosiones: " << initialExplosions.active.size() << std::endl;
+
+    std::vector<int> threadCounts = { 0 };  // 0 = bucles secuenciales sin grabar comandos
+    for (int threads : benchmarkThreadCounts()) threadCounts.push_back(threads);
+
+    int maxThreads = omp_get_max_threads();
+    double sequentialMs = 0;
+    std::vector<Uint32> reference;
+    bool identical = true;
+    for (int threads : threadCounts) {
+        std::vector<Star> stars = initialStars;
+        std::vector<Planet> planets = initialPlanets;
+        PlanetPositions positions = initialPositions;
+        std::vector<Asteroid> asteroids = initialAsteroids;
+        ExplosionPool explosions = initialExplosions;
+        omp_set_num_threads(std::max(threads, 1));
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int frame = 0; frame < numFrames; frame++) {
+            clearCanvas(canvas, {0, 0, 0, 255});
+            updatePlanets(planets, positions, 0);
+            updateAllExplosions(explosions);
+            for (Asteroid& asteroid : asteroids) updateAsteroid(asteroid);
+            if (threads == 0) {
+                for (const Star& star : stars) drawCircle(canvas, star.x, star.y, star.size, {255, 255, 255});
+                for (size_t i = 0; i < planets.size(); i++) {
+                    drawPlanet(canvas, planets[i], interpolate(positions.previousX[i], positions.x[i], 1.0f),
+                               interpolate(positions.previousY[i], positions.y[i], 1.0f));
+                }
+                for (int slot : explosions.active) drawExplosion(canvas, explosions.slots[slot]);
+                for (const Asteroid& asteroid : asteroids) drawAsteroid(canvas, asteroid, 1.0f);
+            } else {
+                drawStars(canvas, stars, 1.0f);
+                drawPlanets(canvas, planets, positions, 1.0f);
+                drawAllExplosions(canvas, explosions);
+                drawAsteroids(canvas, asteroids, 1.0f);
+            }
+        }
+        double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / numFrames;
+
+        if (threads == 0) {
+            sequentialMs = ms;
+            reference = framebuffer;
+            std::cout << "Secuencial: " << ms << " ms/cuadro" << std::endl;
+        } else {
+            identical = identical && framebuffer == reference;
+            std::cout << threads << " hilo(s): " << ms << " ms/cuadro, aceleración " << sequentialMs / ms << "x" << std::endl;
+        }
+    }
+    omp_set_num_threads(maxThreads);
+    releasePlanetSprites();
+
+    // Las listas se envían en orden de hilo, así que la imagen no depende de la cantidad de hilos
+    std::cout << "Píxeles idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Benchmark del pipeline: dibuja cuadros de una escena fija en el framebuffer,
+// primero actualizando y dibujando uno tras otro y luego con el trabajador de
+// simulación calculando el cuadro siguiente mientras se dibuja el actual.
+int runPipelineBenchmark() {
+    const int width = 640, height = 480;
+    const int numFrames = 100;
+    const double stepMs = 1000.0 / 60.0;
+
+    std::vector<Uint32> framebuffer(width * height);
+    Canvas canvas = { nullptr, framebuffer.data(), width, height };
+    randomSeed = 12345;
+    initBlackHole(canvas);
+
+    World initial;
+    createWorld(initial, canvas, 200000, 5000, 200, 5000, defaultExplosionCapacity);
+    savePreviousState(initial);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Nebulosa: " << initial.nebula.x.size() << ", estrellas: " << initial.stars.size()
+              << ", planetas: " << initial.planets.size() << ", asteroides: " << initial.asteroids.size()
+              << ", hilos: " << omp_get_max_threads() << std::endl;
+
+    double frameMs[2];
+    for (int pipelined = 0; pipelined < 2; pipelined++) {
+        World world = initial;
+        SimulationPipeline pipeline;
+        frameProfiler.stages[StagePipelinePublish].pendingTicks = 0;
+        if (pipelined) {
+            startPipeline(pipeline, world, 0, stepMs);
+            launchSteps(pipeline, 1);
+        }
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int frame = 0; frame < numFrames; frame++) {
+            if (pipelined) {
+                collectSteps(pipeline, world);
+                launchSteps(pipeline, 1);
+            } else {
+                updateWorld(world, Uint32(frame * stepMs));
+            }
+            renderWorld(canvas, world, 1.0f);
+        }
+        if (pipelined) {
+            collectSteps(pipeline, world);
+            stopPipeline(pipeline);
+        }
+        frameMs[pipelined] = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / numFrames;
+        std::cout << (pipelined ? "Con pipeline: " : "Secuencial: ") << frameMs[pipelined] << " ms/cuadro, "
+                  << 1000.0 / frameMs[pipelined] << " cuadros/s" << std::endl;
+        if (pipelined) {
+            // Incluida en el tiempo del trabajador: la copia para publicar cada cuadro
+            double publishMs = frameProfiler.stages[StagePipelinePublish].pendingTicks * 1000.0 / SDL_GetPerformanceFrequency() / (numFrames + 1);
+            std::cout << "Publicar el mundo (trabajador): " << publishMs << " ms/cuadro" << std::endl;
+        }
+    }
+    for (StageProfile& stage : frameProfiler.stages) stage.pendingTicks = 0;
+    releasePlanetSprites();
+    releaseBlackHole();
+
+    std::cout << "Ganancia: " << frameMs[0] / frameMs[1] << "x" << std::endl;
+    return 0;
+}
+
+// Benchmark de gravedad: construcción del quadtree y cálculo de fuerzas con
+// 1, 2, 4... hilos para varias cantidades de cuerpos, y error de Barnes-Hut
+// contra la suma exacta en una muestra de cuerpos
+int runGravityBenchmark() {
+    const int width = 640, height = 480;
+    const int numRepeats = 3;
+    const int numSamples = 256;
+    const std::vector<int> bodyCounts = { 25000, 50000, 100000, 200000 };
+
+    std::vector<int> threadCounts = benchmarkThreadCounts();
+    int maxThreads = omp_get_max_threads();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Theta: " << gravityTheta << ", repeticiones: " << numRepeats << " (se informa la mejor)" << std::endl;
+    for (int count : bodyCounts) {
+        GravityBodies bodies;
+        Random random = { 12345 };
+        for (int i = 0; i < count; i++) {
+            bodies.x.push_back(random.below(width * 16) / 16.0f);
+            bodies.y.push_back(random.below(height * 16) / 16.0f);
+            bodies.mass.push_back(1.0f);
+        }
+
+        double oneThreadMs = 0;
+        for (int threads : threadCounts) {
+            omp_set_num_threads(threads);
+            double buildMs = 1e30, forceMs = 1e30;
+            for (int repeat = 0; repeat < numRepeats; repeat++) {
+                Uint64 start = SDL_GetPerformanceCounter();
+                buildQuadTree(gravityTree, bodies);
+                Uint64 built = SDL_GetPerformanceCounter();
+                computeGravity(gravityTree, bodies, gravityTheta);
+                Uint64 end = SDL_GetPerformanceCounter();
+                buildMs = std::min(buildMs, (built - start) * 1000.0 / SDL_GetPerformanceFrequency());
+                forceMs = std::min(forceMs, (end - built) * 1000.0 / SDL_GetPerformanceFrequency());
+            }
+            double totalMs = buildMs + forceMs;
+            if (threads == 1) oneThreadMs = totalMs;
+            std::cout << "Cuerpos: " << count << ", " << threads << " hilo(s): árbol " << buildMs << " ms, fuerzas "
+                      << forceMs << " ms, aceleración " << oneThreadMs / totalMs << "x, "
+                      << totalMs * 1e6 / (count * std::log2(double(count))) << " ns por N·log2(N)" << std::endl;
+        }
+
+        // Error relativo de la aproximación contra la suma directa de todos los pares
+        double errorSum = 0;
+        float softeningSquared = gravitySoftening * gravitySoftening;
+        for (int sample = 0; sample < numSamples; sample++) {
+            int i = int(Uint64(sample) * count / numSamples);
+            double accelX = 0, accelY = 0;
+            for (int j = 0; j < count; j++) {
+                if (j == i) continue;
+                double deltaX = bodies.x[j] - bodies.x[i], deltaY = bodies.y[j] - bodies.y[i];
+                double distanceSquared = deltaX * deltaX + deltaY * deltaY + softeningSquared;
+                double strength = bodies.mass[j] / (distanceSquared * std::sqrt(distanceSquared));
+                accelX += strength * deltaX;
+                accelY += strength * deltaY;
+            }
+            accelX *= gravityConstant;
+            accelY *= gravityConstant;
+            errorSum += std::hypot(bodies.accelX[i] - accelX, bodies.accelY[i] - accelY) / std::hypot(accelX, accelY);
+        }
+        std::cout << "Cuerpos: " << count << ", error relativo medio: " << 100.0 * errorSum / numSamples << " %" << std::endl;
+    }
+    omp_set_num_threads(maxThreads);
+    return 0;
+}
+
+// Comparar la parte simulada de dos mundos (posiciones, planetas visibles y explosiones)
+bool sameWorld(const World& a, const World& b) {
+    if (a.nebula.x != b.nebula.x || a.nebula.y != b.nebula.y) return false;
+    if (a.planetPositions.x != b.planetPositions.x || a.planetPositions.y != b.planetPositions.y) return false;
+    if (a.stars.size() != b.stars.size() || a.asteroids.size() != b.asteroids.size()) return false;
+    for (size_t i = 0; i < a.stars.size(); i++) {
+        if (a.stars[i].x != b.stars[i].x || a.stars[i].y != b.stars[i].y) return false;
+    }
+    for (size_t i = 0; i < a.planets.size(); i++) {
+        if (a.planets[i].isVisible != b.planets[i].isVisible) return false;
+    }
+    for (size_t i = 0; i < a.asteroids.size(); i++) {
+        if (a.asteroids[i].x != b.asteroids[i].x || a.asteroids[i].y != b.asteroids[i].y) return false;
+    }
+    return sameExplosions(a.explosions, b.explosions);
+}
+
+// Benchmark de estrategias: la misma escena fija, actualizada y dibujada en el
+// framebuffer con cada combinación de estrategias. Mide actualización y dibujo
+// por cuadro, la aceleración contra S y verifica que el mundo y los píxeles
+// finales coincidan con los de S.
+int runStrategyBenchmark() {
+    const int width = 640, height = 480;
+    const int numFrames = 60;
+    const double stepMs = 1000.0 / 60.0;
+
+    std::vector<Uint32> framebuffer(width * height);
+    Canvas canvas = { nullptr, framebuffer.data(), width, height };
+    initBlackHole(canvas);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Hilos: " << omp_get_max_threads() << ", cuadros: " << numFrames << std::endl;
+    std::cout << std::left << std::setw(10) << "Estrategia" << std::right << std::setw(14) << "actualizar ms"
+              << std::setw(12) << "dibujar ms" << std::setw(12) << "total ms" << std::setw(13) << "aceleración" << std::endl;
+
+    World reference;
+    std::vector<Uint32> referencePixels;
+    double sequentialMs = 0;
+    bool identical = true;
+    for (const StrategyPreset& preset : strategyPresets) {
+        applyStrategyPreset(preset.name);
+        randomSeed = 12345;
+        World world;
+        createWorld(world, canvas, 200000, 5000, 200, 5000, defaultExplosionCapacity);
+
+        Uint64 updateTicks = 0, renderTicks = 0;
+        for (int frame = 0; frame < numFrames; frame++) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            updateWorld(world, Uint32(frame * stepMs));
+            Uint64 updateEnd = SDL_GetPerformanceCounter();
+            renderWorld(canvas, world, 1.0f);
+            renderTicks += SDL_GetPerformanceCounter() - updateEnd;
+            updateTicks += updateEnd - start;
+        }
+        double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0 * numFrames;
+        double updateMs = updateTicks / ticksPerMs, renderMs = renderTicks / ticksPerMs;
+        if (sequentialMs == 0) {
+            sequentialMs = updateMs + renderMs;
+            reference = world;
+            referencePixels = framebuffer;
+        } else {
+            identical = identical && sameWorld(world, reference) && framebuffer == referencePixels;
+        }
+        std::cout << std::left << std::setw(10) << preset.name << std::right << std::setw(14) << updateMs
+                  << std::setw(12) << renderMs << std::setw(12) << updateMs + renderMs
+                  << std::setw(12) << sequentialMs / (updateMs + renderMs) << "x" << std::endl;
+    }
+    applyStrategyPreset(defaultStrategyPreset);
+    releasePlanetSprites();
+    releaseBlackHole();
+
+    std::cout << "Mundo y píxeles idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Medir una instanciación de un bucle: repetitions llamadas seguidas sobre una
+// copia del mundo inicial. Devuelve ms por llamada y deja el mundo final en result.
+template <typename Policy, typename Loop>
+double timePolicy(const World& initial, World& result, int repetitions, Loop loop) {
+    result = initial;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        loop(Policy(), result, repetition);
+    }
+    return (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / repetitions;
+}
+
+// Benchmark de políticas: cada bucle de la actualización instanciado con cada
+// política de ejecución, lado a lado sobre la misma escena, y verificación de
+// que todas las instanciaciones dejen el mismo mundo que la secuencial
+int runPolicyBenchmark() {
+    const int repetitions = 30;
+    const int numPolicies = 6;
+    const char* const policyNames[numPolicies] = { "secuencial", "static", "dynamic", "tareas", "simd", "par_unseq" };
+
+    std::vector<Uint32> framebuffer(640 * 480);
+    Canvas canvas = { nullptr, framebuffer.data(), 640, 480 };
+    randomSeed = 12345;
+    World initial;
+    createWorld(initial, canvas, 200000, 50000, 2000, 20000, 20000);
+    Random random = streamRandom(StreamScene, 1);
+    while (spawnExplosion(initial.explosions, random.below(640), random.below(480))) {}
+    savePreviousState(initial);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Hilos: " << omp_get_max_threads() << ", repeticiones: " << repetitions
+#ifdef USE_STD_EXECUTION
+              << ", par_unseq: std::execution" << std::endl;
+#else
+              << ", par_unseq: omp parallel for simd" << std::endl;
+#endif
+    std::cout << "ms por llamada" << std::endl << std::left << std::setw(22) << "Bucle" << std::right;
+    for (const char* name : policyNames) std::cout << std::setw(12) << name;
+    std::cout << "  idénticos" << std::endl;
+
+    bool allIdentical = true;
+    // simd y par_unseq solo se miden en las etapas que los admiten; en el resto se imprime -
+    auto measure = [&](const std::string& name, LoopStage stage, auto loop) {
+        World results[numPolicies];
+        bool unsequenced = allowsUnsequenced(stage);
+        double ms[numPolicies] = {
+            timePolicy<SequentialPolicy>(initial, results[0], repetitions, loop),
+            timePolicy<StaticPolicy>(initial, results[1], repetitions, loop),
+            timePolicy<DynamicPolicy>(initial, results[2], repetitions, loop),
+            timePolicy<TaskPolicy>(initial, results[3], repetitions, loop),
+            unsequenced ? timePolicy<SimdPolicy>(initial, results[4], repetitions, loop) : NAN,
+            unsequenced ? timePolicy<ParUnseqPolicy>(initial, results[5], repetitions, loop) : NAN,
+        };
+        bool identical = true;
+        for (int policy = 1; policy < numPolicies; policy++) {
+            if (!std::isnan(ms[policy])) identical = identical && sameWorld(results[policy], results[0]);
+        }
+        allIdentical = allIdentical && identical;
+        std::cout << std::left << std::setw(22) << name << std::right;
+        for (double value : ms) {
+            if (std::isnan(value)) std::cout << std::setw(12) << "-";
+            else std::cout << std::setw(12) << value;
+        }
+        std::cout << "  " << (identical ? "sí" : "no") << std::endl;
+    };
+
+    measure("nebulosa", LoopNebula, [](auto policy, World& world, int repetition) {
+        updateAllNebula(policy, world.nebula, repetition);
+    });
+    measure("estrellas", LoopStars, [](auto policy, World& world, int repetition) {
+        updateStars(policy, world.stars, repetition);
+    });
+    measure("planetas", LoopPlanets, [](auto policy, World& world, int repetition) {
+        updatePlanets(policy, world.planets, world.planetPositions, repetition * 16);
+    });
+    measure("explosiones", LoopExplosions, [](auto policy, World& world, int) {
+        updateAllExplosions(policy, world.explosions);
+    });
+    measure("asteroides", LoopAsteroids, [](auto policy, World& world, int) {
+        updateAsteroids(policy, world.asteroids);
+    });
+
+    // La detección se repite sobre el mismo estado; los efectos se aplican al final
+    CollisionAxis savedAxis = collisionAxis;
+    for (int axis = 0; axis < AxisCount; axis++) {
+        measure(std::string("colisiones/") + collisionAxisNames[axis], LoopCollisions, [&](auto policy, World& world, int repetition) {
+            detectCollisions(policy, world.planets, world.planetPositions, world.asteroids, CollisionAxis(axis));
+            if (repetition == repetitions - 1) applyCollisions(world.planets, world.planetPositions, world.explosions, 0);
+        });
+    }
+    collisionAxis = savedAxis;
+    releasePlanetSprites();
+
+    std::cout << "Mundos idénticos: " << (allIdentical ? "sí" : "no") << std::endl;
+    return allIdentical ? 0 : 1;
+}
+
+// Función para verificar si una cadena es un número
+bool isNumber(const std::string& str) {
+    // Verifica que no esté vacía y que todos los caracteres sean dígitos
+    if (str.empty()) return false;
+    for (char const &c : str) {
+        if (!std::isdigit(c)) return false;
+    }
+    return true;
+}
+
+// Percentil p (0 a 100) de una lista de valores
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    size_t index = std::min(values.size() - 1, size_t(p / 100.0 * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Estadísticas del tiempo entre cuadros en una ventana móvil, en lugar del
+// promedio acumulado desde el inicio, que esconde los tirones y el arranque
+const int frameStatsWindow = 120;  // Cuadros en la ventana (2 s a 60 FPS)
+
+struct FrameStats {
+    double frameMs[frameStatsWindow];  // Anillo con los últimos tiempos entre cuadros
+    int count;                         // Muestras en la ventana
+    int next;                          // Siguiente posición del anillo
+};
+
+// Resumen de la ventana en un instante; una fila del archivo exportado
+struct FrameStatsRow {
+    double time;                   // Segundos desde el inicio
+    double fps;                    // FPS de la ventana
+    double mean, p50, p95, p99, max;  // Tiempo entre cuadros (ms)
+    int hitches;                   // Cuadros de la ventana que tardaron más del doble de la mediana
+};
+
+// Registrar el tiempo de un cuadro (solo copia un número; nada de texto)
+void pushFrameTime(FrameStats& stats, double milliseconds) {
+    stats.frameMs[stats.next] = milliseconds;
+    stats.next = (stats.next + 1) % frameStatsWindow;
+    stats.count = std::min(stats.count + 1, frameStatsWindow);
+}
+
+// Calcular FPS, percentiles y tirones de la ventana actual
+FrameStatsRow summarizeFrameStats(const FrameStats& stats, double time) {
+    std::vector<double> samples(stats.frameMs, stats.frameMs + stats.count);
+    FrameStatsRow row = { time, 0, 0, 0, 0, 0, 0, 0 };
+    if (samples.empty()) return row;
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+        row.max = std::max(row.max, sample);
+    }
+    row.mean = sum / samples.size();
+    row.fps = sum > 0 ? 1000.0 * samples.size() / sum : 0;
+    row.p50 = percentile(samples, 50);
+    row.p95 = percentile(samples, 95);
+    row.p99 = percentile(samples, 99);
+    for (double sample : samples) row.hitches += sample > 2 * row.p50;
+    return row;
+}
+
+// Los archivos exportados son JSON si el nombre termina en .json, y CSV si no
+bool isJsonPath(const std::string& path) {
+    return path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+}
+
+// Tabla exportada fila por fila: en CSV, una línea de encabezado y una línea por
+// fila; en JSON, un arreglo con un objeto por fila. Las celdas se escriben en el
+// orden de columns y la fila se cierra sola al llegar a la última columna.
+struct TableWriter {
+    std::ofstream file;
+    bool json;
+    std::vector<const char*> columns;
+    size_t rows;     // Filas completas escritas
+    size_t column;   // Siguiente columna de la fila actual
+};
+
+bool openTable(TableWriter& table, const std::string& path, const std::vector<const char*>& columns, int precision) {
+    table.file.open(path);
+    if (!table.file) return false;
+    table.json = isJsonPath(path);
+    table.columns = columns;
+    table.rows = table.column = 0;
+    table.file << std::fixed << std::setprecision(precision);
+    if (table.json) {
+        table.file << "[\n";
+    } else {
+        for (size_t i = 0; i < columns.size(); i++) table.file << (i ? "," : "") << columns[i];
+        table.file << "\n";
+    }
+    return true;
+}
+
+// Escribir el separador y el nombre de la celda actual; writeCell pone el valor
+void beginCell(TableWriter& table) {
+    if (table.json) {
+        if (table.column == 0) table.file << (table.rows ? ",\n" : "") << "  {";
+        else table.file << ", ";
+        table.file << "\"" << table.columns[table.column] << "\": ";
+    } else if (table.column > 0) {
+        table.file << ",";
+    }
+}
+
+// Cerrar la celda y, si era la última columna, la fila
+void endCell(TableWriter& table) {
+    if (++table.column < table.columns.size()) return;
+    table.file << (table.json ? "}" : "\n");
+    table.column = 0;
+    table.rows++;
+}
+
+template <typename Value>
+void writeCell(TableWriter& table, const Value& value) {
+    beginCell(table);
+    table.file << value;
+    endCell(table);
+}
+
+// Texto: entre comillas en JSON
+void writeCell(TableWriter& table, const std::string& text) {
+    beginCell(table);
+    if (table.json) table.file << "\"" << text << "\"";
+    else table.file << text;
+    endCell(table);
+}
+
+void writeCell(TableWriter& table, const char* text) {
+    writeCell(table, std::string(text));
+}
+
+// Celda sin valor: null en JSON, vacía en CSV
+void writeEmptyCell(TableWriter& table) {
+    beginCell(table);
+    if (table.json) table.file << "null";
+    endCell(table);
+}
+
+// Valor calculado: si no es finito (por ejemplo, una división por un tiempo de
+// 0 ms) queda sin valor, porque nan e inf no son JSON válido
+void writeNumberCell(TableWriter& table, double value) {
+    if (std::isfinite(value)) writeCell(table, value);
+    else writeEmptyCell(table);
+}
+
+bool closeTable(TableWriter& table) {
+    if (table.json) table.file << (table.rows ? "\n" : "") << "]\n";
+    return bool(table.file);
+}
+
+// Exportar las filas a CSV, o a JSON si el nombre termina en .json
+bool exportFrameStats(const std::string& path, const std::vector<FrameStatsRow>& rows) {
+    TableWriter table;
+    if (!openTable(table, path, { "tiempo_s", "fps", "media_ms", "p50_ms", "p95_ms", "p99_ms", "max_ms", "tirones" }, 3)) return false;
+    for (const FrameStatsRow& row : rows) {
+        writeNumberCell(table, row.time);
+        writeNumberCell(table, row.fps);
+        writeNumberCell(table, row.mean);
+        writeNumberCell(table, row.p50);
+        writeNumberCell(table, row.p95);
+        writeNumberCell(table, row.p99);
+        writeNumberCell(table, row.max);
+        writeCell(table, row.hitches);
+    }
+    return closeTable(table);
+}
+
+// Resumen del modo headless: tiempo total, estadísticas del tiempo por cuadro
+// y cantidad de entidades, en líneas "clave: valor" fáciles de leer desde scripts
+void printHeadlessSummary(const std::vector<double>& frameTimes, double totalSeconds, const World& world, const RegionTotals& regions) {
+    double sum = 0;
+    for (double frameTime : frameTimes) sum += frameTime;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Cuadros: " << frameTimes.size() << std::endl;
+    std::cout << "Hilos: " << omp_get_max_threads() << std::endl;
+    std::cout << "Estrategias:";
+    for (int stage = 0; stage < LoopStageCount; stage++) {
+        std::cout << " " << loopStageNames[stage] << "=" << strategyNames[stageStrategies[stage]];
+    }
+    std::cout << std::endl;
+    std::cout << "Tiempo total: " << totalSeconds << " s" << std::endl;
+    std::cout << "Tiempo por cuadro medio: " << sum / std::max<size_t>(frameTimes.size(), 1) << " ms" << std::endl;
+    std::cout << "Tiempo por cuadro p50: " << percentile(frameTimes, 50) << " ms" << std::endl;
+    std::cout << "Tiempo por cuadro p99: " << percentile(frameTimes, 99) << " ms" << std::endl;
+    double frames = std::max<size_t>(frameTimes.size(), 1);
+    double ticksPerMicrosecond = SDL_GetPerformanceFrequency() / 1e6;
+    std::cout << "Región única: " << (persistentRegion ? "sí" : "no") << std::endl;
+    std::cout << "Regiones paralelas por cuadro: " << regions.regions / frames << std::endl;
+    std::cout << "Fork/join por cuadro: " << regions.forkJoinTicks / ticksPerMicrosecond / frames << " µs" << std::endl;
+    std::cout << "Barreras por cuadro: " << regions.barrierTicks / ticksPerMicrosecond / frames << " µs" << std::endl;
+    std::cout << "Grafo de tareas: " << (graphStats.frames > 0 ? "sí" : "no") << std::endl;
+    if (graphStats.frames > 0) {
+        double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0 * graphStats.frames;
+        auto mostFrequent = std::max_element(graphStats.paths.begin(), graphStats.paths.end(),
+                                             [](const auto& a, const auto& b) { return a.second < b.second; });
+        std::cout << "Grafo, camino crítico por cuadro: " << graphStats.criticalTicks / ticksPerMs << " ms" << std::endl;
+        std::cout << "Grafo, trabajo por cuadro: " << graphStats.workTicks / ticksPerMs << " ms" << std::endl;
+        std::cout << "Grafo, duración por cuadro: " << graphStats.wallTicks / ticksPerMs << " ms" << std::endl;
+        std::cout << "Grafo, paralelismo (trabajo / camino crítico): " << double(graphStats.workTicks) / std::max<Uint64>(graphStats.criticalTicks, 1) << std::endl;
+        std::cout << "Grafo, camino crítico más frecuente: " << mostFrequent->first << " (" << mostFrequent->second << " cuadros)" << std::endl;
+    }
+    std::cout << "Nebulosa: " << world.nebula.x.size() << std::endl;
+    std::cout << "Estrellas: " << world.stars.size() << std::endl;
+    std::cout << "Planetas: " << world.planets.size() << std::endl;
+    std::cout << "Asteroides: " << world.asteroids.size() << std::endl;
+    std::cout << "Explosiones activas: " << world.explosions.active.size() << std::endl;
+    std::cout << "Explosiones descartadas: " << world.explosions.dropped << std::endl;
+}
+
+// Suite de microbenchmarks (--bench-micro): cada primitiva de dibujo y de
+// simulación por separado, para varios radios o cantidades de entidades, sobre
+// el renderer por software de SDL y sobre el framebuffer. Los bucles corren con
+// la estrategia S (un solo hilo) para que los tiempos sean repetibles.
+struct MicroResult {
+    std::string primitive;
+    const char* backend;      // "sdl", "framebuffer" o "-" en las primitivas de simulación
+    const char* parameter;    // "radio", "largo" o "cantidad"
+    int value;
+    Uint64 iterations;        // Operaciones por muestra
+    double minNs, medianNs, meanNs, stddevNs;  // Nanosegundos por operación
+};
+
+const int microSamples = 11;
+const double microSampleMs = 5.0;  // Duración mínima de cada muestra
+
+// Medir operation(): se duplica la cantidad de operaciones hasta que una tanda
+// dure al menos microSampleMs (la última tanda sirve de calentamiento) y luego
+// se toman microSamples tandas de ese tamaño
+template <typename Operation>
+MicroResult measureMicro(const std::string& primitive, const char* backend, const char* parameter, int value, Operation operation) {
+    double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+    Uint64 iterations = 1;
+    while (true) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (Uint64 i = 0; i < iterations; i++) operation();
+        if ((SDL_GetPerformanceCounter() - start) / ticksPerMs >= microSampleMs) break;
+        iterations *= 2;
+    }
+
+    std::vector<double> samples(microSamples);
+    for (double& sample : samples) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (Uint64 i = 0; i < iterations; i++) operation();
+        sample = (SDL_GetPerformanceCounter() - start) / ticksPerMs * 1e6 / iterations;
+    }
+    double sum = 0, squares = 0;
+    for (double sample : samples) sum += sample;
+    double mean = sum / microSamples;
+    for (double sample : samples) squares += (sample - mean) * (sample - mean);
+
+    MicroResult result = { primitive, backend, parameter, value, iterations, 0, 0, mean, std::sqrt(squares / microSamples) };
+    result.minNs = *std::min_element(samples.begin(), samples.end());
+    result.medianNs = percentile(samples, 50);
+    return result;
+}
+
+// Escribir los resultados en CSV o JSON, según la extensión del archivo
+bool exportMicroResults(const std::string& path, const std::vector<MicroResult>& results) {
+    TableWriter table;
+    if (!openTable(table, path, { "primitiva", "backend", "parametro", "valor", "iteraciones", "min_ns", "mediana_ns", "media_ns", "desv_ns" }, 1)) {
+        return false;
+    }
+    for (const MicroResult& result : results) {
+        writeCell(table, result.primitive);
+        writeCell(table, result.backend);
+        writeCell(table, result.parameter);
+        writeCell(table, result.value);
+        writeCell(table, result.iterations);
+        writeNumberCell(table, result.minNs);
+        writeNumberCell(table, result.medianNs);
+        writeNumberCell(table, result.meanNs);
+        writeNumberCell(table, result.stddevNs);
+    }
+    return closeTable(table);
+}
+
+// Planetas en órbitas dentro de la pantalla, con sus sprites ya creados
+void createMicroPlanets(Canvas& canvas, int count, std::vector<Planet>& planets, PlanetPositions& positions) {
+    Random random = { 12345 };
+    planets.assign(count, Planet());
+    for (Planet& planet : planets) {
+        planet = { 320, 240, float(50 + random.below(200)), float(random.below(360)), 0.01f + random.below(10) * 0.001f,
+                   10 + random.below(10), { Uint8(random.below(256)), Uint8(random.below(256)), Uint8(random.below(256)), 255 }, true, 0, 0 };
+        planet.spriteIndex = getPlanetSprite(canvas, planet.size, planet.color);
+    }
+    initPlanetOrbits(planets, positions);
+}
+
+int runMicroBenchmarks(const std::string& path) {
+    const int width = 640, height = 480;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (renderer == nullptr) {
+        std::cerr << "Error: No se pudo crear el renderer por software: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    std::vector<Uint32> framebuffer(width * height);
+    applyStrategyPreset("S");
+    randomSeed = 12345;
+
+    std::vector<MicroResult> results;
+    const char* const backendNames[2] = { "sdl", "framebuffer" };
+    for (int backend = 0; backend < 2; backend++) {
+        Canvas canvas = { renderer, nullptr, width, height };
+        if (backend == 1) canvas = { nullptr, framebuffer.data(), width, height };
+        const char* name = backendNames[backend];
+        initBlackHole(canvas);
+
+        for (int radius : { 1, 2, 5, 10, 20, 50 }) {
+            results.push_back(measureMicro("drawCircle", name, "radio", radius, [&]() {
+                drawCircle(canvas, 320, 240, radius, {255, 255, 255, 255});
+            }));
+        }
+        for (int radius : { 60, 100, 150 }) {
+            results.push_back(measureMicro("drawThinCircle", name, "radio", radius, [&]() {
+                drawThinCircle(canvas, 320, 240, radius, {255, 140, 0, 200}, 2, 0);
+            }));
+        }
+        for (int length : { 50, 100, 200, 400 }) {
+            results.push_back(measureMicro("drawThinLine", name, "largo", length, [&]() {
+                drawThinLine(canvas, 320, 240, length, 2, {255, 140, 0, 200}, 2, 0);
+            }));
+        }
+        results.push_back(measureMicro("drawBlackHole", name, "radio", blackHoleRadius, [&]() {
+            drawBlackHole(canvas, 320, 240, 0);
+        }));
+        for (int radius : { 10, 30, 60 }) {
+            Explosion explosion = { 320, 240, radius, radius * 4 / 5, radius * 2 / 3, radius, true };
+            results.push_back(measureMicro("drawExplosion", name, "radio", radius, [&]() {
+                drawExplosion(canvas, explosion);
+            }));
+        }
+        for (int size : { 5, 10, 20, 40 }) {
+            Planet planet = { 320, 240, 100, 0, 0.01f, size, {200, 100, 50, 255}, true, 0, 0 };
+            planet.spriteIndex = getPlanetSprite(canvas, size, planet.color);
+            results.push_back(measureMicro("drawPlanet", name, "radio", size, [&]() {
+                drawPlanet(canvas, planet, 320, 240);
+            }));
+        }
+        for (int count : { 100, 1000, 10000 }) {
+            std::vector<Planet> planets;
+            PlanetPositions positions;
+            createMicroPlanets(canvas, count, planets, positions);
+            results.push_back(measureMicro("drawPlanets", name, "cantidad", count, [&]() {
+                drawPlanets(canvas, planets, positions, 1.0f);
+            }));
+        }
+        for (int count : { 1000, 10000, 100000 }) {
+            Nebula nebula;
+            initNebula(nebula, count);
+            results.push_back(measureMicro("drawNebula", name, "cantidad", count, [&]() {
+                drawNebula(canvas, nebula, 1.0f);
+            }));
+        }
+        releasePlanetSprites();
+        releaseBlackHole();
+    }
+
+    // Primitivas de simulación: no dibujan, así que no dependen del backend
+    Canvas canvas = { nullptr, framebuffer.data(), width, height };
+    for (int count : { 100, 1000, 10000 }) {
+        std::vector<Planet> planets;
+        PlanetPositions positions;
+        createMicroPlanets(canvas, count, planets, positions);
+        Uint32 currentTime = 0;
+        results.push_back(measureMicro("updatePlanets", "-", "cantidad", count, [&]() {
+            updatePlanets(planets, positions, currentTime += 16);
+        }));
+    }
+    for (int count : { 1000, 10000, 100000 }) {
+        results.push_back(measureMicro("initNebula", "-", "cantidad", count, [&]() {
+            Nebula nebula;
+            initNebula(nebula, count);
+        }));
+    }
+    for (int count : { 1000, 10000, 100000 }) {
+        Nebula nebula;
+        initNebula(nebula, count);
+        Uint32 step = 0;
+        results.push_back(measureMicro("updateAllNebula", "-", "cantidad", count, [&]() {
+            updateAllNebula(nebula, step++);
+        }));
+    }
+    // La detección solo lee el mundo, así que cada operación ve la misma escena
+    for (int count : { 1000, 10000, 100000 }) {
+        World world;
+        createMicroPlanets(canvas, count / 10, world.planets, world.planetPositions);
+        Random random = { 54321 };
+        world.asteroids.resize(count);
+        for (Asteroid& asteroid : world.asteroids) {
+            asteroid = { random.below(width), random.below(height), 5 + random.below(10), 1, 1, {128, 128, 128, 255} };
+        }
+        results.push_back(measureMicro("detectCollisions", "-", "cantidad", count, [&]() {
+            detectCollisions(SequentialPolicy(), world.planets, world.planetPositions, world.asteroids, collisionAxis);
+        }));
+    }
+    releasePlanetSprites();
+    applyStrategyPreset(defaultStrategyPreset);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Muestras: " << microSamples << " de al menos " << microSampleMs << " ms, un hilo" << std::endl;
+    std::cout << std::left << std::setw(18) << "Primitiva" << std::setw(13) << "Backend" << std::setw(10) << "Parámetro"
+              << std::right << std::setw(8) << "Valor" << std::setw(14) << "mediana ns" << std::setw(14) << "mín ns"
+              << std::setw(10) << "desv %" << std::endl;
+    for (const MicroResult& result : results) {
+        std::cout << std::left << std::setw(18) << result.primitive << std::setw(13) << result.backend
+                  << std::setw(10) << result.parameter << std::right << std::setw(8) << result.value
+                  << std::setw(14) << result.medianNs << std::setw(14) << result.minNs
+                  << std::setw(10) << 100.0 * result.stddevNs / result.meanNs << std::endl;
+    }
+    if (!path.empty() && !exportMicroResults(path, results)) {
+        std::cerr << "Error: No se pudo escribir '" << path << "'." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Arnés de escalado (--bench-escalado): la simulación completa en el framebuffer,
+// sin ventana, con 1, 2, 4... hilos y varias cantidades de entidades. Con
+// escalado fuerte el tamaño queda fijo al agregar hilos; con escalado débil
+// crece en proporción a los hilos. Para cada etapa del perfilador se informa
+// la aceleración, la eficiencia y la fracción serial de Karp-Flatt.
+struct ScalingStage {
+    const char* name;
+    ProfileStage first, last;  // Etapas del perfilador que se suman
+};
+const ScalingStage scalingStages[] = {
+    { "actualizar/estado anterior", StageSaveState, StageSaveState },
+    { "actualizar/nebulosa", StageUpdateNebula, StageUpdateNebula },
+    { "actualizar/estrellas", StageUpdateStars, StageUpdateStars },
+    { "actualizar/planetas", StageUpdatePlanets, StageUpdatePlanets },
+    { "actualizar/explosiones", StageUpdateExplosions, StageUpdateExplosions },
+    { "actualizar/asteroides", StageUpdateAsteroids, StageUpdateAsteroids },
+    { "actualizar/colisiones", StageCollisions, StageCollisions },
+    { "dibujar", StageClear, StageDrawAsteroids },
+    { "cuadro completo", StageFrame, StageFrame },
+};
+const int numScalingStages = sizeof(scalingStages) / sizeof(scalingStages[0]);
+
+// Cantidades de entidades de una corrida: nebulosa, estrellas, planetas y asteroides
+struct ScalingSize {
+    int nebula, stars, planets, asteroids;
+    ScalingSize times(int factor) const { return { nebula * factor, stars * factor, planets * factor, asteroids * factor }; }
+};
+
+struct ScalingRow {
+    const char* mode;   // "fuerte" o "debil"
+    ScalingSize size;
+    int threads;
+    const char* stage;
+    double ms, speedup, efficiency, karpFlatt;  // karpFlatt es NaN con un hilo
+};
+
+// Milisegundos por cuadro de cada etapa de scalingStages con threads hilos
+std::vector<double> runScalingCase(Canvas& canvas, int threads, const ScalingSize& size) {
+    const int warmupFrames = 5, numFrames = 30;
+    const double stepMs = 1000.0 / 60.0;
+    omp_set_num_threads(threads);
+    randomSeed = 12345;
+    World world;
+    createWorld(world, canvas, size.nebula, size.stars, size.planets, size.asteroids, defaultExplosionCapacity);
+
+    for (int frame = 0; frame < warmupFrames + numFrames; frame++) {
+        if (frame == warmupFrames) {
+            for (StageProfile& stage : frameProfiler.stages) stage.pendingTicks = 0;
+        }
+        Uint64 start = SDL_GetPerformanceCounter();
+        updateWorld(world, Uint32(frame * stepMs));
+        renderWorld(canvas, world, 1.0f);
+        recordStage(StageFrame, start);
+    }
+
+    std::vector<double> ms(numScalingStages);
+    double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0 * numFrames;
+    for (int i = 0; i < numScalingStages; i++) {
+        Uint64 ticks = 0;
+        for (int stage = scalingStages[i].first; stage <= scalingStages[i].last; stage++) {
+            ticks += frameProfiler.stages[stage].pendingTicks.exchange(0);
+        }
+        ms[i] = ticks / ticksPerMs;
+    }
+    for (StageProfile& stage : frameProfiler.stages) stage.pendingTicks = 0;
+    releasePlanetSprites();
+    return ms;
+}
+
+// Karp-Flatt: fracción serial experimental a partir de la aceleración con p hilos
+double karpFlatt(double speedup, int threads) {
+    if (threads == 1) return NAN;
+    return (1.0 / speedup - 1.0 / threads) / (1.0 - 1.0 / threads);
+}
+
+// Imprimir una tabla (etapas × hilos) y agregar sus filas para exportar. times[t]
+// son los tiempos con threadCounts[t] hilos; en escalado débil la aceleración es
+// la escalada, p · T1 / Tp, porque cada corrida hace p veces más trabajo.
+void reportScaling(const char* mode, const ScalingSize& size, bool weak, const std::vector<int>& threadCounts,
+                   const std::vector<std::vector<double>>& times, std::vector<ScalingRow>& rows) {
+    std::cout << std::left << std::setw(28) << "Etapa" << std::right << std::setw(10) << "T1 ms";
+    for (size_t t = 1; t < threadCounts.size(); t++) {
+        std::cout << std::setw(8) << ("S" + std::to_string(threadCounts[t])) << std::setw(8) << ("E" + std::to_string(threadCounts[t]))
+                  << std::setw(8) << ("e" + std::to_string(threadCounts[t]));
+    }
+    std::cout << std::endl;
+    for (int i = 0; i < numScalingStages; i++) {
+        std::cout << std::left << std::setw(28) << scalingStages[i].name << std::right << std::setw(10) << times[0][i];
+        for (size_t t = 0; t < threadCounts.size(); t++) {
+            int threads = threadCounts[t];
+            double ms = times[t][i];
+            double speedup = ms > 0 ? (weak ? threads : 1) * times[0][i] / ms : NAN;
+            double efficiency = speedup / threads;
+            double serial = karpFlatt(speedup, threads);
+            rows.push_back({ mode, weak ? size.times(threads) : size, threads, scalingStages[i].name, ms, speedup, efficiency, serial });
+            if (t > 0) {
+                for (double value : { speedup, efficiency, serial }) {
+                    if (std::isfinite(value)) std::cout << std::setw(8) << value;
+                    else std::cout << std::setw(8) << "-";
+                }
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Escribir las filas en CSV o JSON, según la extensión del archivo
+bool exportScalingRows(const std::string& path, const std::vector<ScalingRow>& rows) {
+    TableWriter table;
+    if (!openTable(table, path, { "modo", "nebulosa", "estrellas", "planetas", "asteroides", "hilos", "etapa", "ms",
+                                  "aceleracion", "eficiencia", "karp_flatt" }, 4)) {
+        return false;
+    }
+    for (const ScalingRow& row : rows) {
+        writeCell(table, row.mode);
+        writeCell(table, row.size.nebula);
+        writeCell(table, row.size.stars);
+        writeCell(table, row.size.planets);
+        writeCell(table, row.size.asteroids);
+        writeCell(table, row.threads);
+        writeCell(table, row.stage);
+        writeNumberCell(table, row.ms);
+        writeNumberCell(table, row.speedup);
+        writeNumberCell(table, row.efficiency);
+        writeNumberCell(table, row.karpFlatt);
+    }
+    return closeTable(table);
+}
+
+int runScalingBenchmark(const std::string& path) {
+    const int width = 640, height = 480;
+    std::vector<Uint32> framebuffer(width * height);
+    Canvas canvas = { nullptr, framebuffer.data(), width, height };
+    initBlackHole(canvas);
+
+    int maxThreads = omp_get_max_threads();
+    std::vector<int> threadCounts = benchmarkThreadCounts();
+
+    // Escalado fuerte: tres tamaños fijos. Escalado débil: el tamaño base por hilo.
+    const ScalingSize strongSizes[] = { { 25000, 500, 20, 500 }, { 100000, 2000, 80, 2000 }, { 400000, 8000, 320, 8000 } };
+    const ScalingSize weakBase = { 50000, 1000, 40, 1000 };
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Hilos: ";
+    for (int threads : threadCounts) std::cout << threads << " ";
+    std::cout << "(S = aceleración, E = eficiencia, e = fracción serial de Karp-Flatt)" << std::endl;
+
+    std::vector<ScalingRow> rows;
+    for (const ScalingSize& size : strongSizes) {
+        std::vector<std::vector<double>> times;
+        for (int threads : threadCounts) times.push_back(runScalingCase(canvas, threads, size));
+        std::cout << std::endl << "Escalado fuerte: " << size.nebula << " " << size.stars << " " << size.planets << " " << size.asteroids << std::endl;
+        reportScaling("fuerte", size, false, threadCounts, times, rows);
+    }
+    std::vector<std::vector<double>> times;
+    for (int threads : threadCounts) times.push_back(runScalingCase(canvas, threads, weakBase.times(threads)));
+    std::cout << std::endl << "Escalado débil, por hilo: " << weakBase.nebula << " " << weakBase.stars << " " << weakBase.planets << " " << weakBase.asteroids << std::endl;
+    reportScaling("debil", weakBase, true, threadCounts, times, rows);
+
+    omp_set_num_threads(maxThreads);
+    releaseBlackHole();
+    if (!path.empty() && !exportScalingRows(path, rows)) {
+        std::cerr << "Error: No se pudo escribir '" << path << "'." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Una corrida de compareFrameModes: ms por cuadro y regiones paralelas abiertas
+struct FrameModeRun {
+    double frameMs;
+    RegionTotals regions;
+};
+
+// Medir una escena con 1, 2, 4... hilos, primero con una región por bucle y
+// después con runFrame, desde el mismo mundo inicial. Por cada cantidad de hilos
+// llama a report con las dos corridas (la de referencia primero). Devuelve si el
+// mundo y los píxeles finales coincidieron siempre entre ambos modos.
+template <typename RunFrame, typename Report>
+bool compareFrameModes(const ScalingSize& size, int numFrames, RunFrame runFrame, Report report) {
+    const int width = 640, height = 480;
+    const double stepMs = 1000.0 / 60.0;
+
+    std::vector<Uint32> framebuffer(width * height);
+    Canvas canvas = { nullptr, framebuffer.data(), width, height };
+    initBlackHole(canvas);
+
+    int maxThreads = omp_get_max_threads();
+    bool identical = true;
+    for (int threads : benchmarkThreadCounts()) {
+        omp_set_num_threads(threads);
+        World reference;
+        std::vector<Uint32> referencePixels;
+        FrameModeRun runs[2];
+        for (int mode = 0; mode < 2; mode++) {
+            randomSeed = 12345;
+                    World world;
+            createWorld(world, canvas, size.nebula, size.stars, size.planets, size.asteroids, defaultExplosionCapacity);
+
+            RegionTotals start = regionTotals();
+            Uint64 startTicks = SDL_GetPerformanceCounter();
+            double simulationTime = 0;
+            for (int frame = 0; frame < numFrames; frame++) {
+                if (mode == 1) {
+                    runFrame(world, canvas, 1, simulationTime, stepMs, 1.0f);
+                } else {
+                    updateWorld(world, Uint32(simulationTime));
+                    simulationTime += stepMs;
+                    renderWorld(canvas, world, 1.0f);
+                }
+            }
+            runs[mode].frameMs = (SDL_GetPerformanceCounter() - startTicks) * 1000.0 / SDL_GetPerformanceFrequency() / numFrames;
+            runs[mode].regions = regionTotalsSince(start);
+            if (mode == 0) {
+                reference = world;
+                referencePixels = framebuffer;
+            } else {
+                identical = identical && sameWorld(world, reference) && framebuffer == referencePixels;
+            }
+            releasePlanetSprites();
+        }
+        for (StageProfile& stage : frameProfiler.stages) stage.pendingTicks = 0;
+        report(threads, runs);
+    }
+    omp_set_num_threads(maxThreads);
+    releaseBlackHole();
+    return identical;
+}
+
+// Benchmark de la región única (--bench-region): la misma escena con una región
+// paralela por bucle y con una sola región por cuadro, con 1, 2, 4... hilos, en
+// una escena chica (donde pesa la sobrecarga) y una grande. Informa ms por
+// cuadro, regiones por cuadro y el tiempo de fork/join y de barreras, y verifica
+// que el mundo y los píxeles finales coincidan entre ambos modos.
+int runRegionBenchmark() {
+    const int numFrames = 120;
+    const ScalingSize sizes[] = { { 2000, 100, 5, 20 }, { 200000, 5000, 200, 5000 } };
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Cuadros: " << numFrames << ", estrategia: " << defaultStrategyPreset << std::endl;
+    bool identical = true;
+    for (const ScalingSize& size : sizes) {
+        std::cout << std::endl << "Escena: " << size.nebula << " " << size.stars << " " << size.planets << " " << size.asteroids << std::endl;
+        std::cout << std::left << std::setw(8) << "Hilos" << std::setw(12) << "Modo" << std::right << std::setw(10) << "ms/cuadro"
+                  << std::setw(14) << "regiones/c" << std::setw(16) << "fork/join µs/c" << std::setw(16) << "barreras µs/c" << std::endl;
+        identical = compareFrameModes(size, numFrames, runFrameInRegion, [&](int threads, const FrameModeRun runs[2]) {
+            double ticksPerMicrosecond = SDL_GetPerformanceFrequency() / 1e6 * numFrames;
+            for (int mode = 0; mode < 2; mode++) {
+                const RegionTotals& regions = runs[mode].regions;
+                std::cout << std::left << std::setw(8) << threads << std::setw(12) << (mode == 1 ? "por cuadro" : "por bucle")
+                          << std::right << std::setw(10) << runs[mode].frameMs << std::setw(14) << double(regions.regions) / numFrames
+                          << std::setw(16) << regions.forkJoinTicks / ticksPerMicrosecond
+                          << std::setw(16) << regions.barrierTicks / ticksPerMicrosecond << std::endl;
+            }
+        }) && identical;
+    }
+
+    std::cout << "Mundo y píxeles idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+// Benchmark del grafo de tareas (--bench-grafo): la misma escena con una región
+// por bucle y con el grafo de tareas, con 1, 2, 4... hilos. Para el grafo
+// informa el camino crítico, el trabajo total y el paralelismo por cuadro, y la
+// cadena que más veces fue crítica. Verifica que el mundo y los píxeles finales
+// coincidan entre ambos modos.
+int runGraphBenchmark() {
+    const int numFrames = 120;
+    const ScalingSize sizes[] = { { 20000, 500, 60, 300 }, { 200000, 5000, 200, 5000 } };
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Cuadros: " << numFrames << ", estrategia: " << defaultStrategyPreset << std::endl;
+    bool identical = true;
+    for (const ScalingSize& size : sizes) {
+        std::cout << std::endl << "Escena: " << size.nebula << " " << size.stars << " " << size.planets << " " << size.asteroids << std::endl;
+        std::cout << std::left << std::setw(8) << "Hilos" << std::right << std::setw(14) << "bucles ms/c" << std::setw(12) << "grafo ms/c"
+                  << std::setw(12) << "crítico ms" << std::setw(12) << "trabajo ms" << std::setw(13) << "paralelismo" << std::endl;
+        std::string path;
+        graphStats = GraphStats();
+        identical = compareFrameModes(size, numFrames, runFrameGraph, [&](int threads, const FrameModeRun runs[2]) {
+            double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0 * numFrames;
+            std::cout << std::left << std::setw(8) << threads << std::right << std::setw(14) << runs[0].frameMs << std::setw(12) << runs[1].frameMs
+                      << std::setw(12) << graphStats.criticalTicks / ticksPerMs << std::setw(12) << graphStats.workTicks / ticksPerMs
+                      << std::setw(13) << double(graphStats.workTicks) / std::max<Uint64>(graphStats.criticalTicks, 1) << std::endl;
+            auto mostFrequent = std::max_element(graphStats.paths.begin(), graphStats.paths.end(),
+                                                 [](const auto& a, const auto& b) { return a.second < b.second; });
+            path = mostFrequent->first;
+            graphStats = GraphStats();
+        }) && identical;
+        std::cout << "Camino crítico más frecuente: " << path << std::endl;
+    }
+
+    std::cout << "Mundo y píxeles idénticos: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    applyStrategyPreset(defaultStrategyPreset);
+
+    // Separar las opciones (--...) de los parámetros numéricos
+    bool useFramebuffer = false;  // Rasterizar en CPU y subir una textura por cuadro
+    int renderFps = 60;           // Límite de cuadros dibujados por segundo (0 = sin límite)
+    bool headless = false;        // Sin ventana: dibujar fuera de pantalla una cantidad fija de cuadros
+    int headlessFrames = 600;
+    bool showProfile = false;     // Imprimir la tabla del perfilador cada 5 s y al salir
+    std::string statsPath;        // Archivo CSV/JSON para exportar las estadísticas de cuadros
+    Uint64 seed = Uint64(time(0));  // Semilla de la escena (--seed N la repite)
+    int explosionCapacity = defaultExplosionCapacity;  // Explosiones simultáneas como máximo
+    bool usePipeline = false;     // Simular el cuadro siguiente mientras se dibuja el actual
+    std::string strategyPreset = defaultStrategyPreset;  // Combinación de estrategias (--estrategia)
+    std::vector<std::string> stageOverrides;             // Cambios por etapa (--etapa), sobre la combinación
+    std::vector<std::string> params;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--bench-circulos") {
+            // Modo benchmark: compara drawCircle contra la versión por píxel
+            return runCircleBenchmark();
+        } else if (arg == "--bench-planetas") {
+            // Modo benchmark: gradiente por círculos contra sprites pre-rasterizados
+            return runPlanetBenchmark();
+        } else if (arg == "--bench-agujero-negro") {
+            // Modo benchmark: tiempo por etapa de drawBlackHole
+            return runBlackHoleBenchmark();
+        } else if (arg == "--bench-nebulosa") {
+            // Modo benchmark: kernel escalar contra AVX2 de la nebulosa
+            return runNebulaBenchmark();
+        } else if (arg == "--bench-colisiones") {
+            // Modo benchmark: grilla uniforme contra todos contra todos en las colisiones
+            return runCollisionBenchmark();
+        } else if (arg == "--bench-orbitas") {
+            // Modo benchmark: cos/sin por paso contra rotación incremental de las órbitas
+            return runOrbitBenchmark();
+        } else if (arg == "--bench-hilos") {
+            // Modo benchmark: bucles de dibujo secuenciales contra listas de comandos por hilo
+            return runParallelDrawBenchmark();
+        } else if (arg == "--bench-pipeline") {
+            // Modo benchmark: actualizar y dibujar en serie contra el pipeline de simulación
+            return runPipelineBenchmark();
+        } else if (arg == "--bench-gravedad") {
+            // Modo benchmark: quadtree de Barnes-Hut con 1, 2, 4... hilos
+            return runGravityBenchmark();
+        } else if (arg == "--bench-estrategias") {
+            // Modo benchmark: la misma escena con cada combinación de estrategias
+            return runStrategyBenchmark();
+        } else if (arg == "--bench-politicas") {
+            // Modo benchmark: cada bucle de la actualización con cada política de ejecución
+            return runPolicyBenchmark();
+        } else if (arg == "--bench-micro") {
+            // Modo benchmark: cada primitiva por separado; con un archivo, exporta CSV o JSON
+            bool hasPath = i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0;
+            return runMicroBenchmarks(hasPath ? argv[i + 1] : "");
+        } else if (arg == "--bench-escalado") {
+            // Modo benchmark: escalado fuerte y débil por etapa; con un archivo, exporta CSV o JSON
+            bool hasPath = i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0;
+            return runScalingBenchmark(hasPath ? argv[i + 1] : "");
+        } else if (arg == "--bench-region") {
+            // Modo benchmark: una región paralela por bucle contra una sola región por cuadro
+            return runRegionBenchmark();
+        } else if (arg == "--bench-grafo") {
+            // Modo benchmark: una región paralela por bucle contra el grafo de tareas del cuadro
+            return runGraphBenchmark();
+        } else if (arg == "--estrategia" && i + 1 < argc) {
+            strategyPreset = argv[++i];
+        } else if (arg == "--etapa" && i + 1 < argc) {
+            stageOverrides.push_back(argv[++i]);
+        } else if (arg == "--framebuffer") {
+            useFramebuffer = true;
+        } else if (arg == "--pipeline") {
+            usePipeline = true;
+        } else if (arg == "--region-unica") {
+            persistentRegion = true;
+        } else if (arg == "--grafo-tareas") {
+            useTaskGraph = true;
+        } else if (arg == "--estadisticas" && i + 1 < argc) {
+            statsPath = argv[++i];
+        } else if (arg == "--colisiones" && i + 1 < argc) {
+            std::string axis = argv[++i];
+            auto found = std::find(collisionAxisNames, collisionAxisNames + AxisCount, axis);
+            if (found == collisionAxisNames + AxisCount) {
+                std::cerr << "Error: Eje de colisiones desconocido '" << axis << "' (planetas, asteroides o ambos)." << std::endl;
+                return 1;
+            }
+            collisionAxis = CollisionAxis(found - collisionAxisNames);
+        } else if (arg == "--gravedad") {
+            gravityEnabled = true;
+        } else if (arg == "--theta" && i + 1 < argc) {
+            char* end = nullptr;
+            gravityTheta = std::strtof(argv[++i], &end);
+            if (*end != '\0' || !(gravityTheta >= 0)) {
+                std::cerr << "Error: El ángulo de apertura '" << argv[i] << "' no es un número válido." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--perfil") {
+            showProfile = true;
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--frames" && i + 1 < argc && isNumber(argv[i + 1])) {
+            headlessFrames = std::stoi(argv[++i]);
+        } else if (arg == "--fps" && i + 1 < argc && isNumber(argv[i + 1])) {
+            renderFps = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc && isNumber(argv[i + 1])) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--explosiones" && i + 1 < argc && isNumber(argv[i + 1])) {
+            explosionCapacity = std::stoi(argv[++i]);
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Opción desconocida '" << arg << "'." << std::endl;
+            return 1;
+        } else {
+            params.push_back(arg);
+        }
+    }
+
+    // Estrategia de cada bucle: primero la combinación, después los cambios por etapa
+    if (!applyStrategyPreset(strategyPreset)) {
+        std::cerr << "Error: Estrategia desconocida '" << strategyPreset << "' (";
+        for (const StrategyPreset& preset : strategyPresets) {
+            std::cerr << (&preset == strategyPresets ? "" : ", ") << preset.name;
+        }
+        std::cerr << ")." << std::endl;
+        return 1;
+    }
+    for (const std::string& assignment : stageOverrides) {
+        if (!applyStageStrategy(assignment)) {
+            std::cerr << "Error: Etapa '" << assignment << "' no válida (se espera etapa=secuencial|static|dynamic|tareas|simd|par_unseq; simd y par_unseq solo en iniciar-nebulosa, nebulosa y estrellas)." << std::endl;
+            return 1;
+        }
+    }
+
+        // Comprobación de parámetros
+    if (params.size() != 4) {  // Verificar si el número de parámetros es exactamente 4
+        std::cerr << "Error: Se requieren exactamente 4 parámetros: <Número de nebulosas> <Número de estrellas> <Número de planetas> <Número de asteroides> [--framebuffer] [--fps N] [--headless [--frames N]] [--perfil] [--estadisticas archivo.csv|archivo.json] [--seed N] [--explosiones N] [--colisiones planetas|asteroides|ambos] [--gravedad [--theta X]] [--pipeline] [--region-unica] [--grafo-tareas] [--estrategia S|P1|P2|P3|P4|P|paralelo|dinamico|tareas|simd|par_unseq] [--etapa etapa=estrategia]" << std::endl;
+        return 1;
+    }
+
+    // Validar que cada parámetro sea un número
+    for (size_t i = 0; i < params.size(); i++) {
+        if (!isNumber(params[i])) {
+            std::cerr << "Error: El parámetro " << i + 1 << " ('" << params[i] << "') no es un número válido." << std::endl;
+            return 1;
+        }
+    }
+
+    // Convertir los argumentos a enteros
+    int numNebulaPoints = std::stoi(params[0]);
+    int numStars = std::stoi(params[1]);
+    int numPlanets = std::stoi(params[2]);
+    int numAsteroids = std::stoi(params[3]);
+
+    // Inicialización de SDL. En modo headless no se abre ninguna ventana: se
+    // dibuja con un renderer por software sobre una superficie en memoria.
+    SDL_Window* window = nullptr;
+    SDL_Surface* offscreen = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    if (headless) {
+        SDL_Init(SDL_INIT_TIMER);
+        offscreen = SDL_CreateRGBSurfaceWithFormat(0, 640, 480, 32, SDL_PIXELFORMAT_ARGB8888);
+        renderer = offscreen ? SDL_CreateSoftwareRenderer(offscreen) : nullptr;
+    } else {
+        SDL_Init(SDL_INIT_VIDEO);
+        window = SDL_CreateWindow("Space Screensaver",
+                                  SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                  640, 480, SDL_WINDOW_SHOWN);
+        renderer = SDL_CreateRenderer(window, -1, useFramebuffer ? 0 : SDL_RENDERER_ACCELERATED);
+    }
+    if (renderer == nullptr) {
+        std::cerr << "Error: No se pudo crear el renderer: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    // Destino de dibujo: directo al renderer, o a un framebuffer en CPU que se
+    // sube a una textura de streaming una vez por cuadro
+    Canvas canvas = { renderer, nullptr, 640, 480 };
+    std::vector<Uint32> framebuffer;
+    SDL_Texture* frameTexture = nullptr;
+    if (useFramebuffer) {
+        framebuffer.resize(640 * 480);
+        frameTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 640, 480);
+        SDL_SetTextureBlendMode(frameTexture, SDL_BLENDMODE_NONE);  // Copiar el cuadro tal cual
+        canvas = { nullptr, framebuffer.data(), 640, 480 };
+    }
+
+    // Inicialización de variables
+    randomSeed = seed;
+    std::cout << "Semilla: " << seed << std::endl;
+    initBlackHole(canvas);
+    World world;
+    createWorld(world, canvas, numNebulaPoints, numStars, numPlanets, numAsteroids, explosionCapacity);
+    bool running = true;
+    Uint32 startTime = SDL_GetTicks();
+    Uint32 lastFPSTime = SDL_GetTicks();  // Para controlar la impresión del FPS cada segundo
+    FrameStats frameStats = {};
+    std::vector<FrameStatsRow> statsRows;  // Una fila por segundo, para exportar al salir
+    Uint64 updateTicks = 0, renderTicks = 0;  // Tiempo de cada fase desde la última impresión
+    Uint32 phaseFrames = 0;
+    std::vector<double> frameTimes;  // Milisegundos de cada cuadro (modo headless)
+    if (headless) frameTimes.reserve(headlessFrames);
+    Uint64 runStart = SDL_GetPerformanceCounter();
+    RegionTotals regionStart = regionTotals();
+    Uint32 lastProfileTime = SDL_GetTicks();  // Para imprimir el perfil cada 5 segundos
+
+    // La simulación avanza en pasos fijos de 1/60 s, sin importar cuántos
+    // cuadros se dibujen: cada cuadro ejecuta los pasos que le corresponden
+    // según el tiempo real transcurrido y dibuja interpolando entre los dos
+    // últimos. Una máquina lenta dibuja menos cuadros pero no se ralentiza.
+    const double simulationStep = 1000.0 / 60.0;  // Milisegundos por paso
+    const double maxFrameTime = 250.0;            // Tope de tiempo acumulado por cuadro
+    double simulationTime = SDL_GetTicks();
+    double accumulator = 0;
+    Uint64 previousCounter = SDL_GetPerformanceCounter();
+
+    // Con --pipeline los pasos los ejecuta el trabajador mientras se dibuja, y
+    // cada cuadro muestra el estado calculado durante el cuadro anterior
+    SimulationPipeline pipeline;
+    float pipelineAlpha = 0;  // Interpolación de los pasos que está calculando el trabajador
+    if (usePipeline) startPipeline(pipeline, world, simulationTime, simulationStep);
+
+    // Bucle principal
+    while (running) {
+        // Manejo de eventos
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                running = false;
+            }
+        }
+
+        Uint32 currentTime = SDL_GetTicks();
+
+        // Una vez por segundo: resumir la ventana de tiempos, actualizar el título
+        // e imprimir FPS con el tiempo medio de cada fase. El formateo de texto
+        // queda fuera del resto de los cuadros.
+        if (currentTime - lastFPSTime >= 1000) {
+            FrameStatsRow row = summarizeFrameStats(frameStats, (currentTime - startTime) / 1000.0);
+            statsRows.push_back(row);
+
+            std::ostringstream fpsStream;
+            fpsStream << std::fixed << std::setw(2) << std::setprecision(2) << row.fps;
+            std::string fpsFormatted = fpsStream.str();
+            if (window) SDL_SetWindowTitle(window, ("Space Screensaver - FPS: " + fpsFormatted).c_str());
+
+            double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0 * std::max(phaseFrames, Uint32(1));
+            if (!headless) {
+                std::cout << "FPS: " << fpsFormatted << std::fixed << std::setprecision(3)
+                          << " | p99: " << row.p99 << " ms | tirones: " << row.hitches
+                          << " | actualización: " << updateTicks / ticksPerMs << " ms"
+                          << " | dibujo: " << renderTicks / ticksPerMs << " ms" << std::endl;
+            }
+            lastFPSTime = currentTime;
+            updateTicks = renderTicks = 0;
+            phaseFrames = 0;
+        }
+
+        // Fase de actualización: los pasos fijos que cubren el tiempo transcurrido
+        Uint64 phaseStart = SDL_GetPerformanceCounter();
+        // En modo headless cada cuadro avanza exactamente un paso
+        double frameTime = (phaseStart - previousCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+        pushFrameTime(frameStats, frameTime);
+        accumulator += headless ? simulationStep : std::min(frameTime, maxFrameTime);
+        previousCounter = phaseStart;
+        int steps = 0;
+        while (accumulator >= simulationStep) {
+            steps++;
+            accumulator -= simulationStep;
+        }
+        float alpha = float(accumulator / simulationStep);
+        Uint64 updateEnd;
+        if (useTaskGraph && !gravityEnabled && !usePipeline) {
+            // Grafo de tareas: las etapas independientes del cuadro corren a la vez
+            updateEnd = runFrameGraph(world, canvas, steps, simulationTime, simulationStep, alpha);
+        } else if (persistentRegion && !gravityEnabled && !usePipeline) {
+            // Región única: los pasos y el dibujo del cuadro en una sola región paralela
+            updateEnd = runFrameInRegion(world, canvas, steps, simulationTime, simulationStep, alpha);
+        } else {
+            if (usePipeline) {
+                // Recoger el estado calculado durante el cuadro anterior y encargar el siguiente
+                collectSteps(pipeline, world);
+                launchSteps(pipeline, steps);
+                std::swap(alpha, pipelineAlpha);
+            } else {
+                for (int step = 0; step < steps; step++) {
+                    updateWorld(world, Uint32(simulationTime));
+                    simulationTime += simulationStep;
+                }
+            }
+            updateEnd = SDL_GetPerformanceCounter();
+
+            // Fase de dibujo: componer la escena entre el paso anterior y el actual
+            renderWorld(canvas, world, alpha);
+        }
+
+        // Con el backend de CPU, subir el cuadro completo en una sola copia
+        Uint64 uploadStart = SDL_GetPerformanceCounter();
+        if (frameTexture) {
+            SDL_UpdateTexture(frameTexture, nullptr, framebuffer.data(), 640 * sizeof(Uint32));
+            SDL_RenderCopy(renderer, frameTexture, nullptr, nullptr);
+        }
+        Uint64 presentStart = recordStage(StageUpload, uploadStart);
+        updateTicks += updateEnd - phaseStart;
+        renderTicks += presentStart - updateEnd;
+        phaseFrames++;
+
+        // Actualizar la pantalla
+        SDL_RenderPresent(renderer);
+        recordStage(StagePresent, presentStart);
+        recordStage(StageFrame, phaseStart);
+        finishProfileFrame();
+        if (showProfile && !headless && currentTime - lastProfileTime >= 5000) {
+            printProfile();
+            lastProfileTime = currentTime;
+        }
+
+        if (headless) {
+            frameTimes.push_back((SDL_GetPerformanceCounter() - phaseStart) * 1000.0 / SDL_GetPerformanceFrequency());
+            if (int(frameTimes.size()) >= headlessFrames) running = false;
+        }
+
+        // Controlar la tasa de cuadros dibujados por segundo (sin límite en modo headless)
+        Uint32 elapsedTime = SDL_GetTicks() - currentTime;
+        Uint32 frameDelay = renderFps > 0 && !headless ? 1000 / renderFps : 0;
+        if (elapsedTime < frameDelay) {
+            SDL_Delay(frameDelay - elapsedTime);
+        }
+    }
+
+    if (usePipeline) stopPipeline(pipeline);
+    if (headless) {
+        double totalSeconds = double(SDL_GetPerformanceCounter() - runStart) / SDL_GetPerformanceFrequency();
+        printHeadlessSummary(frameTimes, totalSeconds, world, regionTotalsSince(regionStart));
+    }
+    if (showProfile) printProfile();
+    int exitCode = 0;
+    if (!statsPath.empty()) {
+        statsRows.push_back(summarizeFrameStats(frameStats, (SDL_GetTicks() - startTime) / 1000.0));
+        if (!exportFrameStats(statsPath, statsRows)) {
+            std::cerr << "Error: No se pudo escribir '" << statsPath << "'." << std::endl;
+            exitCode = 1;  // Para que un script note que falta el archivo
+        }
+    }
+
+    // Limpiar recursos
+    releasePlanetSprites();
+    releaseBlackHole();
+    if (frameTexture) SDL_DestroyTexture(frameTexture);
+    SDL_DestroyRenderer(renderer);
+    if (offscreen) SDL_FreeSurface(offscreen);
+    if (window) SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    return exitCode;
+}